@@ -20,6 +20,8 @@ import edu.iu.harp.io.Connection;
 import edu.iu.harp.io.Constant;
 import edu.iu.harp.io.Data;
 import edu.iu.harp.io.DataStatus;
+import edu.iu.harp.io.DataUtil;
+import edu.iu.harp.metrics.CollectiveMetrics;
 import edu.iu.harp.worker.WorkerInfo;
 import edu.iu.harp.worker.Workers;
 import org.apache.log4j.Logger;
@@ -140,7 +142,15 @@ public abstract class Sender {
     // Send
     boolean isFailed = false;
     try {
+      long startTime = System.nanoTime();
       handleData(conn, data);
+      CollectiveMetrics.get().record(
+          data.getContextName(),
+          data.getOperationName(),
+          CollectiveMetrics.SEND,
+          DataUtil.getNumEncodedBytes(data),
+          startTime,
+          System.nanoTime());
       conn.release();
     } catch (Exception e) {
       LOG.error("Error in sending data.", e);
@@ -22,6 +22,7 @@ import edu.iu.harp.io.ConnPool;
 import edu.iu.harp.io.Constant;
 import edu.iu.harp.io.Data;
 import edu.iu.harp.io.DataMap;
+import edu.iu.harp.io.DataStatus;
 import edu.iu.harp.io.DataType;
 import edu.iu.harp.io.DataUtil;
 import edu.iu.harp.io.EventQueue;
@@ -35,12 +36,18 @@ import edu.iu.harp.resource.Transferable;
 import edu.iu.harp.server.Server;
 import edu.iu.harp.worker.Workers;
 import it.unimi.dsi.fastutil.ints.Int2ObjectOpenHashMap;
+import it.unimi.dsi.fastutil.ints.IntArrayList;
+import it.unimi.dsi.fastutil.ints.IntOpenHashSet;
 import org.apache.log4j.Logger;
 
+import java.util.Collections;
 import java.util.LinkedList;
 import java.util.List;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
 import java.util.concurrent.ForkJoinPool;
 import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
 
 /*******************************************************
  * Allreduce Collective communication
@@ -59,11 +66,13 @@ public class AllreduceCollective {
     int partitionByteSize =
         Integer.parseInt(args[4]);
     int numPartitions = Integer.parseInt(args[5]);
+    boolean useRing = args.length > 6
+        && args[6].equals("ring");
     Driver.initLogger(workerID);
     LOG.info("args[] " + driverHost + " "
         + driverPort + " " + workerID + " " + jobID
         + " " + partitionByteSize + " "
-        + numPartitions);
+        + numPartitions + " " + useRing);
     // ------------------------------------------------
     // Worker initialize
     EventQueue eventQueue = new EventQueue();
@@ -111,8 +120,13 @@ public class AllreduceCollective {
     // -------------------------------------------------
     // Allreduce
     try {
-      allreduce(contextName, "allreduce", table,
-          dataMap, workers);
+      if (useRing) {
+        ringAllreduce(contextName, "allreduce",
+            table, dataMap, workers);
+      } else {
+        allreduce(contextName, "allreduce", table,
+            dataMap, workers);
+      }
     } catch (Exception e) {
       LOG.error("Fail to allreduce", e);
     }
@@ -290,4 +304,451 @@ public class AllreduceCollective {
     }
     return true;
   }
+
+  /**
+   * Hierarchical allreduce. The partitions are
+   * reduced to the node leader first, then
+   * allreduced among the node leaders, and at
+   * last sent back to the other workers on each
+   * node. Only the node leaders send data across
+   * nodes, so the inter-node traffic scales with
+   * the number of nodes instead of the number of
+   * workers. Within a node the partitions go
+   * through shared segments (see LocalExchange),
+   * the leader encodes the result once for all
+   * the workers on its node.
+   *
+   * @param contextName   the name of the context
+   * @param operationName the name of the operation
+   * @param table         the data Table
+   * @param useRing       if the ring algorithm is
+   *                      used among the node leaders
+   * @param dataMap       the DataMap
+   * @param workers       the Workers
+   * @return true if succeeded, false otherwise
+   */
+  public static <P extends Simple> boolean
+  hierarchicalAllreduce(final String contextName,
+                        final String operationName,
+                        final Table<P> table,
+                        final boolean useRing,
+                        final DataMap dataMap,
+                        final Workers workers) {
+    if (workers.isTheOnlyWorker()) {
+      return true;
+    }
+    int selfID = workers.getSelfID();
+    int leaderID = workers.getNodeLeaderID();
+    List<Integer> localIDs =
+        workers.getLocalWorkerIDs();
+    String reduceOpName =
+        operationName + "-node-reduce";
+    String leaderOpName =
+        operationName + "-node-leaders";
+    String bcastOpName =
+        operationName + "-node-bcast";
+    boolean isSuccess = true;
+    if (selfID == leaderID) {
+      // Reduce within the node
+      List<Transferable> recvPartitions =
+          new LinkedList<>();
+      for (int i = 1; i < localIDs.size(); i++) {
+        Data recvData = LocalExchange.recv(
+            contextName, reduceOpName, dataMap,
+            workers);
+        if (recvData == null) {
+          isSuccess = false;
+          break;
+        }
+        recvData.releaseHeadArray();
+        recvData.releaseBodyArray();
+        recvPartitions.addAll(recvData.getBody());
+      }
+      if (isSuccess) {
+        PartitionUtil.addPartitionsToTable(
+            recvPartitions, table);
+      } else {
+        DataUtil.releaseTransList(recvPartitions);
+      }
+      // Allreduce across the nodes
+      if (isSuccess) {
+        Workers leaders = workers.getNodeLeaders();
+        if (useRing) {
+          isSuccess = ringAllreduce(contextName,
+              leaderOpName, table, dataMap, leaders);
+        } else {
+          isSuccess = allreduce(contextName,
+              leaderOpName, table, dataMap, leaders);
+        }
+        dataMap.cleanOperationData(contextName,
+            leaderOpName);
+      }
+      // Send the result to the node
+      if (isSuccess && localIDs.size() > 1) {
+        List<Transferable> ownedPartitions =
+            new LinkedList<>(table.getPartitions());
+        Data sendData =
+            new Data(DataType.PARTITION_LIST,
+                contextName, selfID, ownedPartitions,
+                DataUtil.getNumTransListBytes(
+                    ownedPartitions),
+                bcastOpName, table.getNumPartitions());
+        List<Integer> destIDs = new LinkedList<>();
+        for (int localID : localIDs) {
+          if (localID != selfID) {
+            destIDs.add(localID);
+          }
+        }
+        if (!LocalExchange.send(sendData, destIDs,
+            workers)) {
+          LOG.error("Fail to send the result to "
+              + destIDs);
+          isSuccess = false;
+        }
+        sendData.releaseHeadArray();
+        sendData.releaseBodyArray();
+      }
+    } else {
+      List<Transferable> ownedPartitions =
+          new LinkedList<>(table.getPartitions());
+      Data sendData =
+          new Data(DataType.PARTITION_LIST,
+              contextName, selfID, ownedPartitions,
+              DataUtil
+                  .getNumTransListBytes(ownedPartitions),
+              reduceOpName, table.getNumPartitions());
+      boolean isSent = LocalExchange.send(sendData,
+          Collections.singletonList(leaderID),
+          workers);
+      sendData.releaseHeadArray();
+      sendData.releaseBodyArray();
+      Data recvData = null;
+      if (isSent) {
+        // The local partitions are replaced by the
+        // allreduced ones
+        table.release();
+        recvData = LocalExchange.recv(contextName,
+            bcastOpName, dataMap, workers);
+      } else {
+        LOG.error("Fail to send the partitions to "
+            + "the node leader " + leaderID);
+      }
+      if (recvData == null) {
+        isSuccess = false;
+      } else {
+        recvData.releaseHeadArray();
+        recvData.releaseBodyArray();
+        PartitionUtil.addPartitionsToTable(
+            recvData.getBody(), table);
+      }
+    }
+    dataMap.cleanOperationData(contextName,
+        reduceOpName);
+    dataMap.cleanOperationData(contextName,
+        bcastOpName);
+    return isSuccess;
+  }
+
+  /**
+   * Check if the ring algorithm should be used
+   * for the allreduce on this table. The ring
+   * algorithm needs at least one partition per
+   * worker and pays off on large tables. The
+   * result depends on the local table only, so
+   * the workers must agree on it before the
+   * allreduce, otherwise they can pick different
+   * algorithms and block each other.
+   *
+   * @param table   the data Table
+   * @param workers the Workers
+   * @return true if the ring algorithm is
+   * preferred, false otherwise
+   */
+  public static <P extends Simple> boolean
+  isRingPreferred(final Table<P> table,
+                  final Workers workers) {
+    if (table.getNumPartitions() < workers
+        .getNumWorkers()) {
+      return false;
+    }
+    long numBytes = 0L;
+    for (Partition<P> partition : table
+        .getPartitions()) {
+      numBytes += partition.getNumEnocdeBytes();
+    }
+    return numBytes >= Constant.RING_MIN_TABLE_SIZE;
+  }
+
+  /**
+   * Allreduce communication operation with the
+   * ring algorithm, a reduce-scatter followed by
+   * an allgather. Partitions are grouped into
+   * one chunk per worker by partition ID. Chunks
+   * travel around the ring in segments, so a
+   * segment is forwarded to the next worker
+   * while the following one is still being
+   * received and combined. Each worker sends
+   * about 2 * (N - 1) / N of the table in total.
+   *
+   * @param contextName   the name of the context
+   * @param operationName the name of the operation
+   * @param table         the data Table
+   * @param dataMap       the DataMap
+   * @param workers       the Workers
+   * @return true if succeeded, false otherwise
+   */
+  public static <P extends Simple> boolean
+  ringAllreduce(final String contextName,
+                final String operationName,
+                final Table<P> table,
+                final DataMap dataMap,
+                final Workers workers) {
+    if (workers.isTheOnlyWorker()) {
+      return true;
+    }
+    final int selfID = workers.getSelfID();
+    final int minID = workers.getMinID();
+    final int numWorkers = workers.getNumWorkers();
+    final int rank = selfID - minID;
+    final int nextID = workers.getNextID();
+    final int numSteps = 2 * (numWorkers - 1);
+    // Group the local partition IDs to chunks
+    IntArrayList[] chunkIDs =
+        new IntArrayList[numWorkers];
+    for (int i = 0; i < numWorkers; i++) {
+      chunkIDs[i] = new IntArrayList();
+    }
+    for (Partition<P> partition : table
+        .getPartitions()) {
+      chunkIDs[Math.floorMod(partition.id(),
+          numWorkers)].add(partition.id());
+    }
+    // Sending runs on its own thread, so the
+    // wire time of a segment overlaps with
+    // combining the next one
+    ExecutorService sendExecutor =
+        Executors.newSingleThreadExecutor();
+    AtomicBoolean isSendFailed =
+        new AtomicBoolean(false);
+    boolean isFailed = false;
+    // Step 0, send the chunk of this worker
+    List<Transferable> segment =
+        new LinkedList<>();
+    int segmentBytes = 0;
+    int numSentSegments = 0;
+    IntArrayList ownedIDs = chunkIDs[rank];
+    for (int i = 0; i < ownedIDs.size(); i++) {
+      Partition<P> partition =
+          table.getPartition(ownedIDs.getInt(i));
+      segment.add(partition);
+      segmentBytes += partition.getNumEnocdeBytes();
+      if (segmentBytes >= Constant.RING_SEGMENT_SIZE
+          && i < ownedIDs.size() - 1) {
+        numSentSegments++;
+        isFailed |= !sendSegment(contextName,
+            getStepOperationName(operationName, 0),
+            segment, 0, nextID, workers,
+            sendExecutor, isSendFailed);
+        segment = new LinkedList<>();
+        segmentBytes = 0;
+      }
+    }
+    numSentSegments++;
+    isFailed |= !sendSegment(contextName,
+        getStepOperationName(operationName, 0),
+        segment, numSentSegments, nextID, workers,
+        sendExecutor, isSendFailed);
+    // Receive, combine (or replace) and forward
+    for (int step = 0; step < numSteps
+        && !isFailed; step++) {
+      boolean isReduceStep =
+          step < numWorkers - 1;
+      boolean isForwardStep = step < numSteps - 1;
+      String stepOpName =
+          getStepOperationName(operationName, step);
+      String nextStepOpName = getStepOperationName(
+          operationName, step + 1);
+      IntOpenHashSet forwardedIDs =
+          new IntOpenHashSet();
+      List<Transferable> pending = null;
+      int numRecvSegments = 0;
+      int numSegments = 0;
+      numSentSegments = 0;
+      while (numSegments == 0
+          || numRecvSegments < numSegments) {
+        Data recvData = IOUtil.waitAndGet(dataMap,
+            contextName, stepOpName);
+        if (recvData == null) {
+          isFailed = true;
+          break;
+        }
+        recvData.releaseHeadArray();
+        recvData.releaseBodyArray();
+        numRecvSegments++;
+        // The last segment of a step carries the
+        // number of segments in this step
+        if (recvData.getPartitionID() > 0) {
+          numSegments = recvData.getPartitionID();
+        }
+        List<Transferable> recvPartitions =
+            recvData.getBody();
+        IntArrayList recvIDs = new IntArrayList(
+            recvPartitions.size());
+        for (Transferable obj : recvPartitions) {
+          recvIDs.add(((Partition<P>) obj).id());
+        }
+        if (isReduceStep) {
+          PartitionUtil.addPartitionsToTable(
+              recvPartitions, table);
+        } else {
+          replacePartitions(recvPartitions, table);
+        }
+        if (isForwardStep) {
+          if (pending != null) {
+            numSentSegments++;
+            isFailed |= !sendSegment(contextName,
+                nextStepOpName, pending, 0, nextID,
+                workers, sendExecutor,
+                isSendFailed);
+          }
+          pending = new LinkedList<>();
+          for (int i = 0; i < recvIDs.size(); i++) {
+            int partitionID = recvIDs.getInt(i);
+            pending.add(
+                table.getPartition(partitionID));
+            forwardedIDs.add(partitionID);
+          }
+        }
+      }
+      if (!isFailed && isForwardStep) {
+        if (isReduceStep) {
+          // Local partitions in this chunk which
+          // the previous worker doesn't have
+          IntArrayList ids =
+              chunkIDs[Math.floorMod(rank - step - 1,
+                  numWorkers)];
+          for (int i = 0; i < ids.size(); i++) {
+            int partitionID = ids.getInt(i);
+            if (!forwardedIDs.contains(partitionID)) {
+              pending.add(
+                  table.getPartition(partitionID));
+            }
+          }
+        }
+        numSentSegments++;
+        isFailed |= !sendSegment(contextName,
+            nextStepOpName, pending, numSentSegments,
+            nextID, workers, sendExecutor,
+            isSendFailed);
+      }
+    }
+    sendExecutor.shutdown();
+    try {
+      if (!sendExecutor.awaitTermination(
+          Constant.DATA_MAX_WAIT_TIME,
+          TimeUnit.SECONDS)) {
+        isFailed = true;
+      }
+    } catch (InterruptedException e) {
+      LOG.error("Fail to wait for sending.", e);
+      isFailed = true;
+    }
+    for (int step = 0; step < numSteps; step++) {
+      dataMap.cleanOperationData(contextName,
+          getStepOperationName(operationName, step));
+    }
+    if (isFailed || isSendFailed.get()) {
+      table.release();
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Get the name of the operation used by one
+   * step of the ring allreduce
+   *
+   * @param operationName the name of the operation
+   * @param step          the step
+   * @return the operation name of the step
+   */
+  private static String getStepOperationName(
+      String operationName, int step) {
+    return operationName + "-ring-" + step;
+  }
+
+  /**
+   * Encode a segment of partitions and send it
+   * on the send thread. The segment is encoded
+   * on the caller thread so the partitions can
+   * be updated right after this call returns.
+   *
+   * @param contextName   the name of the context
+   * @param operationName the name of the operation
+   * @param segment       the partitions to send
+   * @param numSegments   the number of segments in
+   *                      this step if this is the
+   *                      last segment, 0 otherwise
+   * @param destID        the destination
+   * @param workers       the Workers
+   * @param sendExecutor  the send thread
+   * @param isSendFailed  set if the sending fails
+   * @return true if the segment is submitted,
+   * false otherwise
+   */
+  private static boolean sendSegment(
+      String contextName, String operationName,
+      List<Transferable> segment, int numSegments,
+      int destID, Workers workers,
+      ExecutorService sendExecutor,
+      AtomicBoolean isSendFailed) {
+    final Data sendData =
+        new Data(DataType.PARTITION_LIST,
+            contextName, workers.getSelfID(),
+            segment,
+            DataUtil.getNumTransListBytes(segment),
+            operationName, numSegments);
+    if (sendData
+        .encodeHead() != DataStatus.ENCODED_ARRAY_DECODED
+        || sendData
+        .encodeBody() != DataStatus.ENCODED_ARRAY_DECODED) {
+      sendData.releaseHeadArray();
+      sendData.releaseBodyArray();
+      return false;
+    }
+    sendExecutor.execute(() -> {
+      DataSender sender = new DataSender(sendData,
+          destID, workers, Constant.SEND_DECODE);
+      if (!sender.execute()) {
+        isSendFailed.set(true);
+      }
+      // Release the encoded arrays only, the
+      // partitions are still in the table
+      sendData.releaseHeadArray();
+      sendData.releaseBodyArray();
+    });
+    return true;
+  }
+
+  /**
+   * Replace the partitions in the table with the
+   * received ones of the same IDs
+   *
+   * @param partitions the received partitions
+   * @param table      the data Table
+   */
+  private static <P extends Simple> void
+  replacePartitions(List<Transferable> partitions,
+                    Table<P> table) {
+    for (Transferable obj : partitions) {
+      Partition<P> partition = (Partition<P>) obj;
+      Partition<P> oldPartition =
+          table.removePartition(partition.id());
+      if (oldPartition != null) {
+        oldPartition.release();
+      }
+      table.addPartition(partition);
+    }
+    partitions.clear();
+  }
 }
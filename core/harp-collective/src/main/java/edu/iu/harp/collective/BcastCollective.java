@@ -42,7 +42,9 @@ import edu.iu.harp.util.Ack;
 import edu.iu.harp.worker.Workers;
 import org.apache.log4j.Logger;
 
+import java.util.Collections;
 import java.util.LinkedList;
+import java.util.List;
 import java.util.concurrent.ForkJoinPool;
 import java.util.concurrent.TimeUnit;
 
@@ -384,4 +386,193 @@ public class BcastCollective {
       }
     }
   }
+
+  /**
+   * Hierarchical broadcast. The data goes to the
+   * leader of the broadcasting node, then to the
+   * other node leaders through a binomial tree,
+   * and at last to the other workers on each
+   * node. Only the node leaders send data across
+   * nodes. Within a node the data goes through
+   * shared segments (see LocalExchange).
+   *
+   * @param contextName   the name of the context
+   * @param operationName the name of the operation
+   * @param table         the data Table
+   * @param bcastWorkerID the worker which broadcasts
+   * @param dataMap       the DataMap
+   * @param workers       the Workers
+   * @return true if succeeded, false otherwise
+   */
+  public static <P extends Simple> boolean
+  hierarchicalBroadcast(String contextName,
+                        String operationName, Table<P> table,
+                        int bcastWorkerID, DataMap dataMap,
+                        Workers workers) {
+    if (workers.isTheOnlyWorker()) {
+      return true;
+    }
+    int selfID = workers.getSelfID();
+    int bcastLeaderID =
+        workers.getNodeLeaderID(bcastWorkerID);
+    String upOpName = operationName + "-node-up";
+    String leaderOpName =
+        operationName + "-node-leaders";
+    String downOpName =
+        operationName + "-node-down";
+    boolean isSuccess = true;
+    if (selfID == bcastWorkerID
+        && selfID != bcastLeaderID) {
+      isSuccess = sendTable(contextName, upOpName,
+          table, bcastLeaderID, workers);
+    }
+    if (workers.isNodeLeader()) {
+      if (selfID == bcastLeaderID
+          && selfID != bcastWorkerID) {
+        isSuccess = recvTable(contextName, upOpName,
+            table, dataMap, workers);
+      }
+      if (isSuccess) {
+        isSuccess = treeBroadcast(contextName,
+            leaderOpName, table,
+            workers.getNodeID(bcastWorkerID),
+            dataMap, workers.getNodeLeaders());
+        dataMap.cleanOperationData(contextName,
+            leaderOpName);
+      }
+      if (isSuccess) {
+        List<Transferable> ownedPartitions =
+            new LinkedList<>(table.getPartitions());
+        Data sendData = new Data(
+            DataType.PARTITION_LIST, contextName,
+            selfID, ownedPartitions,
+            DataUtil
+                .getNumTransListBytes(ownedPartitions),
+            downOpName, table.getNumPartitions());
+        List<Integer> destIDs = new LinkedList<>();
+        for (int localID : workers
+            .getLocalWorkerIDs()) {
+          if (localID != selfID
+              && localID != bcastWorkerID) {
+            destIDs.add(localID);
+          }
+        }
+        isSuccess = LocalExchange.send(sendData,
+            destIDs, workers);
+        sendData.releaseHeadArray();
+        sendData.releaseBodyArray();
+      }
+    } else if (selfID != bcastWorkerID) {
+      isSuccess = recvTable(contextName, downOpName,
+          table, dataMap, workers);
+    }
+    dataMap.cleanOperationData(contextName,
+        upOpName);
+    dataMap.cleanOperationData(contextName,
+        downOpName);
+    return isSuccess;
+  }
+
+  /**
+   * Broadcast through a binomial tree with
+   * point-to-point sends. Unlike the chain and
+   * MST broadcast, the data is not relayed by the
+   * receivers of the server, so this works on a
+   * view of a subset of the workers.
+   *
+   * @param contextName   the name of the context
+   * @param operationName the name of the operation
+   * @param table         the data Table
+   * @param bcastWorkerID the worker which broadcasts
+   * @param dataMap       the DataMap
+   * @param workers       the Workers
+   * @return true if succeeded, false otherwise
+   */
+  public static <P extends Simple> boolean
+  treeBroadcast(String contextName,
+                String operationName, Table<P> table,
+                int bcastWorkerID, DataMap dataMap,
+                Workers workers) {
+    if (workers.isTheOnlyWorker()) {
+      return true;
+    }
+    int selfID = workers.getSelfID();
+    int minID = workers.getMinID();
+    int numWorkers = workers.getNumWorkers();
+    int rank = Math.floorMod(selfID - bcastWorkerID,
+        numWorkers);
+    Data data = null;
+    if (rank == 0) {
+      List<Transferable> ownedPartitions =
+          new LinkedList<>(table.getPartitions());
+      data = new Data(DataType.PARTITION_LIST,
+          contextName, selfID, ownedPartitions,
+          DataUtil
+              .getNumTransListBytes(ownedPartitions),
+          operationName, table.getNumPartitions());
+    } else {
+      data = IOUtil.waitAndGet(dataMap, contextName,
+          operationName);
+      if (data == null) {
+        return false;
+      }
+    }
+    // Send to the children in the tree. Keep
+    // sending to the other children so that they
+    // do not wait until timeout
+    boolean isSuccess = true;
+    for (int mask = 1; mask < numWorkers;
+         mask <<= 1) {
+      if (rank < mask && rank + mask < numWorkers) {
+        int destID = minID + Math.floorMod(
+            rank + mask + bcastWorkerID - minID,
+            numWorkers);
+        Sender sender = new DataSender(data, destID,
+            workers, Constant.SEND_DECODE);
+        isSuccess &= sender.execute();
+      }
+    }
+    data.releaseHeadArray();
+    data.releaseBodyArray();
+    if (rank != 0) {
+      PartitionUtil.addPartitionsToTable(
+          data.getBody(), table);
+    }
+    return isSuccess;
+  }
+
+  private static <P extends Simple> boolean
+  sendTable(String contextName,
+            String operationName, Table<P> table,
+            int destID, Workers workers) {
+    List<Transferable> ownedPartitions =
+        new LinkedList<>(table.getPartitions());
+    Data sendData = new Data(
+        DataType.PARTITION_LIST, contextName,
+        workers.getSelfID(), ownedPartitions,
+        DataUtil
+            .getNumTransListBytes(ownedPartitions),
+        operationName, table.getNumPartitions());
+    boolean isSuccess = LocalExchange.send(sendData,
+        Collections.singletonList(destID), workers);
+    sendData.releaseHeadArray();
+    sendData.releaseBodyArray();
+    return isSuccess;
+  }
+
+  private static <P extends Simple> boolean
+  recvTable(String contextName,
+            String operationName, Table<P> table,
+            DataMap dataMap, Workers workers) {
+    Data recvData = LocalExchange.recv(contextName,
+        operationName, dataMap, workers);
+    if (recvData == null) {
+      return false;
+    }
+    recvData.releaseHeadArray();
+    recvData.releaseBodyArray();
+    PartitionUtil.addPartitionsToTable(
+        recvData.getBody(), table);
+    return true;
+  }
 }
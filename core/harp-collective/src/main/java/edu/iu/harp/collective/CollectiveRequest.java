@@ -0,0 +1,158 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.collective;
+
+import org.apache.log4j.Logger;
+
+import java.util.concurrent.CompletableFuture;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.Executor;
+import java.util.function.BooleanSupplier;
+
+/*******************************************************
+ * The handle of a collective communication
+ * operation in flight. The table used by the
+ * operation must not be accessed until the
+ * operation completes. Operations with different
+ * context/operation names can be in flight at
+ * the same time.
+ * <p>
+ * The operation is the blocking collective run
+ * on another thread. It overlaps with the
+ * computation of the caller, but completion is
+ * for the whole table only: the collectives
+ * receive a partition list per message and add
+ * it to the table at the end, so there is no
+ * partition-by-partition completion.
+ ******************************************************/
+public class CollectiveRequest {
+
+  private static final Logger LOG =
+    Logger.getLogger(CollectiveRequest.class);
+
+  private final String contextName;
+  private final String operationName;
+  private final CompletableFuture<Boolean> future;
+
+  private CollectiveRequest(String contextName,
+    String operationName,
+    CompletableFuture<Boolean> future) {
+    this.contextName = contextName;
+    this.operationName = operationName;
+    this.future = future;
+  }
+
+  /**
+   * Start a collective communication operation
+   * on the executor.
+   *
+   * @param contextName
+   *          the name of the context
+   * @param operationName
+   *          the name of the operation
+   * @param collective
+   *          the blocking collective operation
+   * @param executor
+   *          the executor running the operation
+   * @return the handle of the operation
+   */
+  public static CollectiveRequest start(
+    String contextName, String operationName,
+    BooleanSupplier collective,
+    Executor executor) {
+    return new CollectiveRequest(contextName,
+      operationName, CompletableFuture.supplyAsync(
+        collective::getAsBoolean, executor));
+  }
+
+  /**
+   * Get the name of the context
+   *
+   * @return the name of the context
+   */
+  public String getContextName() {
+    return contextName;
+  }
+
+  /**
+   * Get the name of the operation
+   *
+   * @return the name of the operation
+   */
+  public String getOperationName() {
+    return operationName;
+  }
+
+  /**
+   * Check if the operation is completed without
+   * blocking
+   *
+   * @return true if completed, false otherwise
+   */
+  public boolean test() {
+    return future.isDone();
+  }
+
+  /**
+   * Wait for the operation to complete
+   *
+   * @return true if the operation succeeded,
+   *         false otherwise
+   */
+  public boolean waitFor() {
+    do {
+      try {
+        return future.get();
+      } catch (InterruptedException e) {
+        LOG.info("Retry. context name: "
+          + contextName + ", operationName: "
+          + operationName);
+      } catch (ExecutionException e) {
+        LOG.error("Fail to do " + operationName
+          + " in " + contextName, e);
+        return false;
+      }
+    } while (true);
+  }
+
+  /**
+   * Get the future of the operation, for
+   * chaining computation to its completion
+   *
+   * @return the future of the operation
+   */
+  public CompletableFuture<Boolean> getFuture() {
+    return future;
+  }
+
+  /**
+   * Wait for all the operations to complete
+   *
+   * @param requests
+   *          the handles of the operations
+   * @return true if all the operations
+   *         succeeded, false otherwise
+   */
+  public static boolean
+    waitForAll(CollectiveRequest... requests) {
+    boolean isSuccess = true;
+    for (CollectiveRequest request : requests) {
+      isSuccess &= request.waitFor();
+    }
+    return isSuccess;
+  }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.collective;
+
+import edu.iu.harp.client.DataSender;
+import edu.iu.harp.io.Constant;
+import edu.iu.harp.io.Data;
+import edu.iu.harp.io.DataMap;
+import edu.iu.harp.io.DataType;
+import edu.iu.harp.io.DataUtil;
+import edu.iu.harp.io.IOUtil;
+import edu.iu.harp.io.SharedSegment;
+import edu.iu.harp.resource.IntArray;
+import edu.iu.harp.resource.Transferable;
+import edu.iu.harp.worker.Workers;
+import org.apache.log4j.Logger;
+
+import java.io.File;
+import java.util.LinkedList;
+import java.util.List;
+
+/*******************************************************
+ * Send data to the workers on the same node
+ * through shared segments. The data is encoded
+ * once into a segment, each receiver gets a link
+ * to it and a short notification through the
+ * connection. If the segment cannot be written,
+ * the data is sent through the connections.
+ ******************************************************/
+public class LocalExchange {
+
+  protected static final Logger LOG =
+      Logger.getLogger(LocalExchange.class);
+
+  /**
+   * Send the data to the workers on the same
+   * node. The data is encoded if it is not.
+   *
+   * @param data    the operation Data
+   * @param destIDs the receivers on this node
+   * @param workers the Workers
+   * @return true if succeeded, false otherwise
+   */
+  public static boolean send(Data data,
+                             List<Integer> destIDs, Workers workers) {
+    if (destIDs.isEmpty()) {
+      return true;
+    }
+    String contextName = data.getContextName();
+    String operationName = data.getOperationName();
+    int selfID = workers.getSelfID();
+    File segment = null;
+    if (SharedSegment.isEnabled()) {
+      segment = SharedSegment.getFile(contextName,
+          operationName, selfID, destIDs.get(0));
+      if (!SharedSegment.write(data, segment)) {
+        LOG.info("Send " + operationName
+            + " through the connections.");
+        segment = null;
+      }
+    }
+    boolean isSuccess = true;
+    List<Integer> linkedIDs = new LinkedList<>();
+    for (int destID : destIDs) {
+      File file = SharedSegment.getFile(contextName,
+          operationName, selfID, destID);
+      if (segment != null && (file.equals(segment)
+          || SharedSegment.link(segment, file))) {
+        linkedIDs.add(destID);
+      } else {
+        // Keep sending to the other workers so
+        // that they do not wait until timeout
+        isSuccess &= new DataSender(data, destID,
+            workers, Constant.SEND_DECODE).execute();
+      }
+    }
+    // Notify after all the links are made, the
+    // first receiver deletes the segment file
+    for (int destID : linkedIDs) {
+      if (!notify(contextName, operationName,
+          destID, workers)) {
+        SharedSegment.getFile(contextName,
+            operationName, selfID, destID).delete();
+        isSuccess = false;
+      }
+    }
+    return isSuccess;
+  }
+
+  /**
+   * Receive the data sent by a worker on the same
+   * node, either through a segment or through the
+   * connection.
+   *
+   * @param contextName   the name of the context
+   * @param operationName the name of the operation
+   * @param dataMap       the DataMap
+   * @param workers       the Workers
+   * @return the decoded Data, null if failed
+   */
+  public static Data recv(String contextName,
+                          String operationName, DataMap dataMap,
+                          Workers workers) {
+    Data data = IOUtil.waitAndGet(dataMap,
+        contextName, operationName);
+    if (data == null || data
+        .getBodyType() != DataType.SIMPLE_LIST) {
+      return data;
+    }
+    int srcID = data.getWorkerID();
+    data.release();
+    return SharedSegment.read(SharedSegment.getFile(
+        contextName, operationName, srcID,
+        workers.getSelfID()));
+  }
+
+  private static boolean notify(
+      String contextName, String operationName,
+      int destID, Workers workers) {
+    IntArray array = IntArray.create(1, false);
+    array.get()[0] = workers.getSelfID();
+    List<Transferable> objs = new LinkedList<>();
+    objs.add(array);
+    Data data = new Data(DataType.SIMPLE_LIST,
+        contextName, workers.getSelfID(), objs,
+        DataUtil.getNumTransListBytes(objs),
+        operationName);
+    boolean isSuccess = new DataSender(data,
+        destID, workers, Constant.SEND_DECODE)
+        .execute();
+    data.release();
+    return isSuccess;
+  }
+}
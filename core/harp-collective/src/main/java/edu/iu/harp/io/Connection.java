@@ -23,6 +23,7 @@ import java.net.InetAddress;
 import java.net.InetSocketAddress;
 import java.net.Socket;
 import java.net.SocketAddress;
+import java.nio.channels.SocketChannel;
 
 /*******************************************************
  * The connection object as a client
@@ -34,6 +35,8 @@ public class Connection {
   private OutputStream out;
   private InputStream in;
   private Socket socket;
+  /** Only set with the NIO transport */
+  private SocketChannel channel;
   private final boolean useCache;
 
   /**
@@ -56,7 +59,15 @@ public class Connection {
           InetAddress.getByName(node);
       SocketAddress sockaddr =
           new InetSocketAddress(addr, port);
-      this.socket = new Socket();
+      if (Transport.get() == Transport.NIO) {
+        // A blocking channel, so the streams
+        // still work and gathering writes are
+        // available
+        this.channel = SocketChannel.open();
+        this.socket = channel.socket();
+      } else {
+        this.socket = new Socket();
+      }
       IOUtil.setSocketOptions(socket);
       this.socket.connect(sockaddr, timeOutMs);
       this.out = socket.getOutputStream();
@@ -103,6 +114,17 @@ public class Connection {
     return this.in;
   }
 
+  /**
+   * Get the SocketChannel
+   *
+   * @return the SocketChannel, null if the
+   * connection is not opened by the NIO
+   * transport
+   */
+  public SocketChannel getChannel() {
+    return this.channel;
+  }
+
   /**
    * Close the connection
    */
@@ -130,6 +152,7 @@ public class Connection {
       out = null;
       in = null;
       socket = null;
+      channel = null;
     }
   }
 
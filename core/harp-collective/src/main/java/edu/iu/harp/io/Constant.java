@@ -43,6 +43,12 @@ public class Constant {
   // 256 KB
   public static final int BUFFER_SIZE = 262144;
   // 256 KB
+  public static final int RING_SEGMENT_SIZE =
+    4194304;
+  // 4 MB
+  public static final int RING_MIN_TABLE_SIZE =
+    8388608;
+  // 8 MB
   public static final int MAX_ARRAY_SIZE =
     Integer.MAX_VALUE - 5;
 
@@ -54,6 +60,7 @@ public class Constant {
 
   public static final int NUM_THREADS =
     Runtime.getRuntime().availableProcessors();
+  public static final int NUM_NIO_EVENT_LOOPS = 4;
   public static final int DEFAULT_WORKER_POART_BASE =
     12800;
 
@@ -16,6 +16,7 @@
 
 package edu.iu.harp.io;
 
+import edu.iu.harp.metrics.CollectiveMetrics;
 import edu.iu.harp.resource.ByteArray;
 import edu.iu.harp.resource.Transferable;
 import org.apache.log4j.Logger;
@@ -475,6 +476,7 @@ public class Data {
       // If body status is encoded array
       // body array cannot be null.
       // body object must be null;
+      long startTime = System.nanoTime();
       if (bodyType == DataType.SIMPLE_LIST) {
         body =
             DataUtil.decodeSimpleList(bodyArray);
@@ -485,6 +487,10 @@ public class Data {
         LOG.error("Cannot decode unknown body: "
             + bodyType);
       }
+      CollectiveMetrics.get().record(contextName,
+          operationName, CollectiveMetrics.DECODE,
+          bodyArray.size(), startTime,
+          System.nanoTime());
       if (body == null) {
         bodyStatus =
             DataStatus.ENCODED_ARRAY_DECODE_FAILED;
@@ -588,6 +594,7 @@ public class Data {
       }
       DataOutput dataOut =
           new Serializer(bodyArray);
+      long startTime = System.nanoTime();
       if (bodyType == DataType.SIMPLE_LIST
           || bodyType == DataType.PARTITION_LIST) {
         try {
@@ -601,6 +608,9 @@ public class Data {
         LOG.info(
             "Cannot encode unknown data type.");
       }
+      CollectiveMetrics.get().record(contextName,
+          operationName, CollectiveMetrics.ENCODE,
+          bodySize, startTime, System.nanoTime());
       if (bodyArray != null) {
         bodyStatus =
             DataStatus.ENCODED_ARRAY_DECODED;
@@ -31,4 +31,7 @@ public class DataType {
   public static final byte WRITABLE = 7;
   public static final byte SIMPLE_LIST = 8;
   public static final byte PARTITION_LIST = 9;
+  // Partitions of Writables of the same class,
+  // the class is written once
+  public static final byte WRITABLE_BATCH = 10;
 }
@@ -18,6 +18,7 @@ package edu.iu.harp.io;
 
 import edu.iu.harp.client.Event;
 import edu.iu.harp.client.EventType;
+import edu.iu.harp.metrics.CollectiveMetrics;
 import edu.iu.harp.partition.Partition;
 import edu.iu.harp.resource.ByteArray;
 import edu.iu.harp.resource.DoubleArray;
@@ -28,6 +29,7 @@ import edu.iu.harp.resource.ShortArray;
 import edu.iu.harp.resource.Simple;
 import edu.iu.harp.resource.Transferable;
 import edu.iu.harp.resource.Writable;
+import edu.iu.harp.resource.WritableRegistry;
 import org.apache.log4j.Logger;
 
 import java.io.DataInput;
@@ -252,16 +254,29 @@ public class DataUtil {
    */
   public static Writable
   deserializeWritable(DataInput din) {
-    String className = null;
+    Class<Writable> clazz = null;
     try {
-      className = din.readUTF();
+      clazz = WritableRegistry.get().readClass(din);
     } catch (Exception e) {
       LOG.error(
           "Fail to deserialize the class name", e);
       return null;
     }
-    Writable obj = Writable
-        .create(Writable.forClass(className));
+    return deserializeWritable(din, clazz);
+  }
+
+  /**
+   * Deserialize the data from a Deserializer as a
+   * Writable of the given class
+   *
+   * @param din   the Deserializer
+   * @param clazz the class of the Writable
+   * @return a Writable deserialized from the
+   * Deserializer
+   */
+  private static Writable deserializeWritable(
+      DataInput din, Class<Writable> clazz) {
+    Writable obj = Writable.create(clazz);
     if (obj == null) {
       return null;
     }
@@ -271,13 +286,53 @@ public class DataUtil {
     } catch (Exception e) {
       LOG.error(
           "Fail to deserialize writable with class name "
-              + className,
+              + clazz.getName(),
           e);
       obj.release();
       return null;
     }
   }
 
+  /**
+   * Deserialize a batch of Writable partitions
+   * and add them to the partition list
+   *
+   * @param decoder    the Deserializer
+   * @param partitions the partition list
+   * @return true if succeeded
+   */
+  private static boolean decodeWritableBatch(
+      Deserializer decoder,
+      List<Transferable> partitions) {
+    Class<Writable> clazz = null;
+    int numPartitions = 0;
+    try {
+      clazz =
+          WritableRegistry.get().readClass(decoder);
+      numPartitions = decoder.readInt();
+    } catch (Exception e) {
+      LOG.error(
+          "Fail to decode writable batch.", e);
+      return false;
+    }
+    for (int i = 0; i < numPartitions; i++) {
+      int partitionID = 0;
+      try {
+        partitionID = decoder.readInt();
+      } catch (IOException e) {
+        return false;
+      }
+      Writable partition =
+          deserializeWritable(decoder, clazz);
+      if (partition == null) {
+        return false;
+      }
+      partitions.add(new Partition<Simple>(
+          partitionID, partition));
+    }
+    return true;
+  }
+
   /**
    * Decode the ByteArray as a list of
    * Transferable objects
@@ -373,6 +428,13 @@ public class DataUtil {
             deserializeDoubleArray(decoder);
       } else if (dataType == DataType.WRITABLE) {
         partition = deserializeWritable(decoder);
+      } else if (dataType == DataType.WRITABLE_BATCH) {
+        if (!decodeWritableBatch(decoder,
+            partitions)) {
+          releaseTransList(partitions);
+          return null;
+        }
+        continue;
       } else {
         LOG.info("Unkown data type.");
       }
@@ -423,6 +485,25 @@ public class DataUtil {
     }
   }
 
+  /**
+   * Get the number of encoded head and body bytes
+   * of the data, the bytes counted as sent and
+   * received in the metrics
+   *
+   * @param data the Data
+   * @return the number of bytes
+   */
+  public static long getNumEncodedBytes(Data data) {
+    long numBytes = 0L;
+    if (data.getHeadArray() != null) {
+      numBytes += data.getHeadArray().size();
+    }
+    if (data.getBodyArray() != null) {
+      numBytes += data.getBodyArray().size();
+    }
+    return numBytes;
+  }
+
   /**
    * Get the size in bytes of the encoded data
    *
@@ -432,8 +513,20 @@ public class DataUtil {
   public static int getNumTransListBytes(
       List<Transferable> objs) {
     int size = 0;
-    for (Transferable obj : objs) {
-      size += obj.getNumEnocdeBytes();
+    Class<?> batchClass = getBatchClass(objs);
+    if (batchClass != null) {
+      // Data type, class and count
+      size = 1 + WritableRegistry.get()
+          .getNumClassBytes(batchClass) + 4;
+      // Partition ID and body of each partition
+      for (Transferable obj : objs) {
+        size += 4 + ((Writable) ((Partition<?>) obj)
+            .get()).getNumWriteBytes();
+      }
+    } else {
+      for (Transferable obj : objs) {
+        size += obj.getNumEnocdeBytes();
+      }
     }
     if (size == 0) {
       size = 1;
@@ -456,12 +549,78 @@ public class DataUtil {
       dataOut
           .writeByte(DataType.UNKNOWN_DATA_TYPE);
     } else {
-      for (Transferable obj : objs) {
-        obj.encode(dataOut);
+      Class<?> batchClass = getBatchClass(objs);
+      if (batchClass != null) {
+        encodeWritableBatch(objs, batchClass,
+            dataOut);
+      } else {
+        for (Transferable obj : objs) {
+          obj.encode(dataOut);
+        }
       }
     }
   }
 
+  /**
+   * Get the class of the partition bodies if the
+   * list can be encoded as a batch, which writes
+   * the class once for the whole list. A batch
+   * holds at least
+   * WritableRegistry.MIN_BATCH_SIZE partitions
+   * whose bodies are Writables of the same class.
+   *
+   * @param objs the data to be encoded
+   * @return the class, or null if the list
+   * cannot be encoded as a batch
+   */
+  private static Class<?>
+  getBatchClass(List<Transferable> objs) {
+    if (!WritableRegistry.get().useBatch()
+        || objs.size() < WritableRegistry.MIN_BATCH_SIZE) {
+      return null;
+    }
+    Class<?> batchClass = null;
+    for (Transferable obj : objs) {
+      if (!(obj instanceof Partition)) {
+        return null;
+      }
+      Simple body = ((Partition<?>) obj).get();
+      if (!(body instanceof Writable)) {
+        return null;
+      }
+      if (batchClass == null) {
+        batchClass = body.getClass();
+      } else if (batchClass != body.getClass()) {
+        return null;
+      }
+    }
+    return batchClass;
+  }
+
+  /**
+   * Encode the partitions as a batch: the data
+   * type, the class and the number of partitions,
+   * then the ID and the body of each partition.
+   *
+   * @param objs       the partitions
+   * @param batchClass the class of the bodies
+   * @param dataOut    the DataOutput
+   * @throws IOException if an error happens
+   */
+  private static void encodeWritableBatch(
+      List<Transferable> objs, Class<?> batchClass,
+      DataOutput dataOut) throws IOException {
+    dataOut.writeByte(DataType.WRITABLE_BATCH);
+    WritableRegistry.get().writeClass(dataOut,
+        batchClass);
+    dataOut.writeInt(objs.size());
+    for (Transferable obj : objs) {
+      Partition<?> partition = (Partition<?>) obj;
+      dataOut.writeInt(partition.id());
+      ((Writable) partition.get()).write(dataOut);
+    }
+  }
+
   /**
    * Transferable List may include different types
    * Identify each of them and release
@@ -509,6 +668,10 @@ public class DataUtil {
         .getBodyStatus() == DataStatus.ENCODED_ARRAY
         || data
         .getBodyStatus() == DataStatus.ENCODED_ARRAY_DECODED)) {
+      CollectiveMetrics.get().recordReceive(
+          data.getContextName(),
+          data.getOperationName(),
+          getNumEncodedBytes(data));
       if (data.isOperationData()) {
         dataMap.putData(data);
       } else if (data.isData()) {
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.io;
+
+import java.nio.ByteBuffer;
+import java.util.ArrayDeque;
+
+/*******************************************************
+ * A pool of direct buffers for the channel
+ * writes. A heap buffer written to a channel is
+ * copied by the JDK into a temporary direct
+ * buffer as large as the write, which is kept
+ * per thread. The senders copy the data into a
+ * pooled direct buffer of Constant.BUFFER_SIZE
+ * instead and write it chunk by chunk.
+ ******************************************************/
+public class DirectBufferPool {
+
+  private static final DirectBufferPool instance =
+    new DirectBufferPool(Constant.BUFFER_SIZE,
+      Constant.NUM_THREADS);
+
+  private final int bufferSize;
+  private final int maxNumFreeBuffers;
+  private final ArrayDeque<ByteBuffer> freeBuffers;
+
+  /**
+   * Initialization
+   *
+   * @param bufferSize
+   *          the size of each buffer
+   * @param maxNumFreeBuffers
+   *          the max number of the buffers kept
+   *          for reuse
+   */
+  public DirectBufferPool(int bufferSize,
+    int maxNumFreeBuffers) {
+    this.bufferSize = bufferSize;
+    this.maxNumFreeBuffers = maxNumFreeBuffers;
+    this.freeBuffers = new ArrayDeque<>();
+  }
+
+  public static DirectBufferPool get() {
+    return instance;
+  }
+
+  /**
+   * Get a cleared direct buffer, a new one if
+   * no buffer is free
+   *
+   * @return the buffer
+   */
+  public ByteBuffer acquire() {
+    ByteBuffer buffer = null;
+    synchronized (freeBuffers) {
+      buffer = freeBuffers.pollFirst();
+    }
+    if (buffer == null) {
+      buffer = ByteBuffer.allocateDirect(bufferSize);
+    }
+    return buffer;
+  }
+
+  /**
+   * Return a buffer to the pool. The buffer is
+   * dropped if the pool is full.
+   *
+   * @param buffer
+   *          the buffer from acquire
+   */
+  public void release(ByteBuffer buffer) {
+    buffer.clear();
+    synchronized (freeBuffers) {
+      if (freeBuffers.size() < maxNumFreeBuffers) {
+        freeBuffers.addFirst(buffer);
+      }
+    }
+  }
+
+  public int getNumFreeBuffers() {
+    synchronized (freeBuffers) {
+      return freeBuffers.size();
+    }
+  }
+}
@@ -16,6 +16,7 @@
 
 package edu.iu.harp.io;
 
+import edu.iu.harp.metrics.CollectiveMetrics;
 import org.apache.log4j.Logger;
 
 import java.io.IOException;
@@ -128,13 +129,25 @@ public class IOUtil {
   public static Data waitAndGet(DataMap dataMap,
     String contextName, String operationName) {
     int count = 0;
+    long startTime = System.nanoTime();
     do {
       try {
-        return dataMap.waitAndGetData(contextName,
-          operationName,
+        Data data = dataMap.waitAndGetData(
+          contextName, operationName,
           Constant.DATA_MAX_WAIT_TIME);
+        // A timed out wait has no source worker
+        CollectiveMetrics.get().recordWait(
+          contextName, operationName,
+          data != null ? data.getWorkerID()
+            : Constant.UNKNOWN_WORKER_ID,
+          startTime, System.nanoTime());
+        return data;
       } catch (InterruptedException e) {
         if (count == Constant.SMALL_RETRY_COUNT) {
+          CollectiveMetrics.get().recordWait(
+            contextName, operationName,
+            Constant.UNKNOWN_WORKER_ID, startTime,
+            System.nanoTime());
           return null;
         }
         count++;
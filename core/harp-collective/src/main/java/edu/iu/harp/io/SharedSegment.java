@@ -0,0 +1,270 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.io;
+
+import edu.iu.harp.metrics.CollectiveMetrics;
+import edu.iu.harp.resource.ByteArray;
+import org.apache.log4j.Logger;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.file.Files;
+
+/*******************************************************
+ * Memory-mapped segments for the data exchanged
+ * between the workers on the same node. The
+ * sender maps a file in a node-local directory
+ * and copies the encoded head and body into it,
+ * the receiver maps the same file and decodes
+ * from it. The data does not go through the
+ * sockets, only a short notification does. The
+ * directory is on tmpfs (/dev/shm) when it
+ * exists, so the pages are never written to a
+ * disk.
+ ******************************************************/
+public class SharedSegment {
+
+  private static final Logger LOG =
+    Logger.getLogger(SharedSegment.class);
+
+  // Two ints for the head size and the body size
+  private static final int PREFIX_SIZE = 8;
+
+  private static volatile File dir =
+    getDefaultDir();
+  private static volatile boolean isEnabled =
+    true;
+
+  /**
+   * Get the default directory of the segments
+   *
+   * @return /dev/shm/harp-user if /dev/shm is
+   *         writable, or under java.io.tmpdir
+   */
+  public static File getDefaultDir() {
+    File shm = new File("/dev/shm");
+    File base = shm.isDirectory() && shm.canWrite()
+      ? shm
+      : new File(System.getProperty("java.io.tmpdir"));
+    return new File(base,
+      "harp-" + System.getProperty("user.name"));
+  }
+
+  /**
+   * Set the directory of the segments. Use a
+   * different directory for each job on a node.
+   *
+   * @param d
+   *          the directory
+   */
+  public static void setDir(File d) {
+    dir = d;
+  }
+
+  public static File getDir() {
+    return dir;
+  }
+
+  /**
+   * Enable or disable the segments. When
+   * disabled, the workers on the same node send
+   * data through the connections.
+   *
+   * @param enabled
+   *          if the segments are used
+   */
+  public static void setEnabled(boolean enabled) {
+    isEnabled = enabled;
+  }
+
+  public static boolean isEnabled() {
+    return isEnabled;
+  }
+
+  /**
+   * Get the file of the segment sent from a
+   * worker to another one for an operation
+   *
+   * @param contextName
+   *          the name of the context
+   * @param operationName
+   *          the name of the operation
+   * @param srcID
+   *          the sender
+   * @param destID
+   *          the receiver
+   * @return the file
+   */
+  public static File getFile(String contextName,
+    String operationName, int srcID, int destID) {
+    return new File(dir,
+      (contextName + "." + operationName)
+        .replaceAll("[^A-Za-z0-9._-]", "_") + "."
+        + srcID + "-" + destID);
+  }
+
+  /**
+   * Write the encoded head and body of the data
+   * to a segment. The data is encoded if it is
+   * not.
+   *
+   * @param data
+   *          the Data
+   * @param file
+   *          the file of the segment
+   * @return true if succeeded, false otherwise
+   */
+  public static boolean write(Data data,
+    File file) {
+    if (data.encodeHead() != DataStatus.ENCODED_ARRAY_DECODED
+      || data
+        .encodeBody() != DataStatus.ENCODED_ARRAY_DECODED) {
+      return false;
+    }
+    ByteArray headArray = data.getHeadArray();
+    ByteArray bodyArray = data.getBodyArray();
+    long size = (long) PREFIX_SIZE
+      + headArray.size() + bodyArray.size();
+    if (size > Integer.MAX_VALUE) {
+      return false;
+    }
+    long startTime = System.nanoTime();
+    RandomAccessFile raf = null;
+    try {
+      Files.createDirectories(dir.toPath());
+      raf = new RandomAccessFile(file, "rw");
+      MappedByteBuffer buffer = raf.getChannel()
+        .map(FileChannel.MapMode.READ_WRITE, 0L,
+          size);
+      buffer.putInt(headArray.size());
+      buffer.putInt(bodyArray.size());
+      buffer.put(headArray.get(),
+        headArray.start(), headArray.size());
+      buffer.put(bodyArray.get(),
+        bodyArray.start(), bodyArray.size());
+    } catch (IOException e) {
+      LOG.error("Fail to write segment " + file, e);
+      file.delete();
+      return false;
+    } finally {
+      close(raf);
+    }
+    CollectiveMetrics.get().record(
+      data.getContextName(),
+      data.getOperationName(),
+      CollectiveMetrics.SEND, size - PREFIX_SIZE,
+      startTime, System.nanoTime());
+    return true;
+  }
+
+  /**
+   * Make the segment of the source file
+   * available as another file, without copying
+   *
+   * @param src
+   *          the file of the segment
+   * @param dest
+   *          the new file
+   * @return true if succeeded, false otherwise
+   */
+  public static boolean link(File src,
+    File dest) {
+    try {
+      Files.deleteIfExists(dest.toPath());
+      Files.createLink(dest.toPath(),
+        src.toPath());
+      return true;
+    } catch (IOException
+      | UnsupportedOperationException e) {
+      LOG.error("Fail to link segment " + dest, e);
+      return false;
+    }
+  }
+
+  /**
+   * Read and decode the data in a segment. The
+   * file is deleted, the pages are freed when no
+   * other file links to them.
+   *
+   * @param file
+   *          the file of the segment
+   * @return the decoded Data, null if failed
+   */
+  public static Data read(File file) {
+    long startTime = System.nanoTime();
+    ByteArray headArray = null;
+    ByteArray bodyArray = null;
+    RandomAccessFile raf = null;
+    try {
+      raf = new RandomAccessFile(file, "r");
+      FileChannel channel = raf.getChannel();
+      MappedByteBuffer buffer = channel.map(
+        FileChannel.MapMode.READ_ONLY, 0L,
+        channel.size());
+      int headSize = buffer.getInt();
+      int bodySize = buffer.getInt();
+      headArray = ByteArray.create(headSize, true);
+      bodyArray = ByteArray.create(bodySize, true);
+      if (headArray == null || bodyArray == null) {
+        throw new IOException(
+          "Cannot get the arrays of " + file);
+      }
+      buffer.get(headArray.get(), 0, headSize);
+      buffer.get(bodyArray.get(), 0, bodySize);
+    } catch (IOException e) {
+      LOG.error("Fail to read segment " + file, e);
+      if (headArray != null) {
+        headArray.release();
+      }
+      if (bodyArray != null) {
+        bodyArray.release();
+      }
+      return null;
+    } finally {
+      close(raf);
+      file.delete();
+    }
+    Data data = new Data(headArray, bodyArray);
+    if (data
+      .decodeHeadArray() != DataStatus.ENCODED_ARRAY_DECODED
+      || data
+        .decodeBodyArray() != DataStatus.ENCODED_ARRAY_DECODED) {
+      data.release();
+      return null;
+    }
+    CollectiveMetrics.get().record(
+      data.getContextName(),
+      data.getOperationName(),
+      CollectiveMetrics.RECEIVE,
+      headArray.size() + bodyArray.size(),
+      startTime, System.nanoTime());
+    return data;
+  }
+
+  private static void close(RandomAccessFile raf) {
+    if (raf != null) {
+      try {
+        raf.close();
+      } catch (IOException e) {
+        LOG.error("Fail to close segment.", e);
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.io;
+
+/*******************************************************
+ * The transport backends. BIO uses blocking
+ * sockets with one thread per connection on the
+ * server. NIO uses socket channels served by a
+ * few event-loop threads. Both use the same wire
+ * format. The backend is selected by the
+ * "harp.transport" system property or set
+ * before the server starts.
+ ******************************************************/
+public enum Transport {
+  BIO, NIO;
+
+  public static final String TRANSPORT =
+    "harp.transport";
+
+  private static volatile Transport transport =
+    parse(System.getProperty(TRANSPORT), BIO);
+
+  /**
+   * Get the transport in use
+   *
+   * @return the transport
+   */
+  public static Transport get() {
+    return transport;
+  }
+
+  /**
+   * Set the transport. Call this before creating
+   * the server and the connections.
+   *
+   * @param t
+   *          the transport
+   */
+  public static void set(Transport t) {
+    transport = t;
+  }
+
+  /**
+   * Parse the name of a transport
+   *
+   * @param name
+   *          the name, "bio" or "nio"
+   * @param defaultTransport
+   *          returned if the name is unknown
+   * @return the transport
+   */
+  public static Transport parse(String name,
+    Transport defaultTransport) {
+    if (name == null) {
+      return defaultTransport;
+    }
+    try {
+      return valueOf(name.trim().toUpperCase());
+    } catch (IllegalArgumentException e) {
+      return defaultTransport;
+    }
+  }
+}
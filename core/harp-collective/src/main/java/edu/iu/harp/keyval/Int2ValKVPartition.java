@@ -17,6 +17,7 @@
 package edu.iu.harp.keyval;
 
 import edu.iu.harp.resource.Writable;
+import edu.iu.harp.resource.WritableRegistry;
 import it.unimi.dsi.fastutil.ints.Int2ObjectMap;
 import it.unimi.dsi.fastutil.ints.Int2ObjectOpenHashMap;
 import it.unimi.dsi.fastutil.objects.ObjectIterator;
@@ -170,7 +171,8 @@ public abstract class Int2ValKVPartition<V extends Value>
     // mapSize
     int size = 4;
     // vClass name
-    size += (vClass.getName().length() * 2 + 4);
+    size += WritableRegistry.get()
+      .getNumClassBytes(vClass);
     size += (kvMap.size() * 4);
     // Key + each array size
     ObjectIterator<Int2ObjectMap.Entry<V>> iterator =
@@ -191,7 +193,8 @@ public abstract class Int2ValKVPartition<V extends Value>
   public void write(DataOutput out)
     throws IOException {
     out.writeInt(this.kvMap.size());
-    out.writeUTF(this.vClass.getName());
+    WritableRegistry.get().writeClass(out,
+      this.vClass);
     ObjectIterator<Int2ObjectMap.Entry<V>> iterator =
       this.kvMap.int2ObjectEntrySet()
         .fastIterator();
@@ -219,7 +222,7 @@ public abstract class Int2ValKVPartition<V extends Value>
     }
     try {
       this.vClass =
-        Writable.forClass(in.readUTF());
+        WritableRegistry.get().readClass(in);
       for (int i = 0; i < size; i++) {
         V val = null;
         if (freeVals.isEmpty()) {
@@ -17,6 +17,7 @@
 package edu.iu.harp.keyval;
 
 import edu.iu.harp.resource.Writable;
+import edu.iu.harp.resource.WritableRegistry;
 import it.unimi.dsi.fastutil.objects.Object2ObjectMap;
 import it.unimi.dsi.fastutil.objects.Object2ObjectOpenHashMap;
 import it.unimi.dsi.fastutil.objects.ObjectIterator;
@@ -222,10 +223,11 @@ public abstract class Key2ValKVPartition<K extends Key, V extends Value>
     int size = 4;
     // kClass name
     size +=
-      (this.kClass.getName().length() * 2 + 4);
+      WritableRegistry.get()
+        .getNumClassBytes(this.kClass);
     // vClass name
-    size +=
-      (this.vClass.getName().length() * 2 + 4);
+    size += WritableRegistry.get()
+      .getNumClassBytes(this.vClass);
     // Key + each array size
     ObjectIterator<Object2ObjectMap.Entry<K, V>> iterator =
       this.kvMap.object2ObjectEntrySet()
@@ -246,8 +248,10 @@ public abstract class Key2ValKVPartition<K extends Key, V extends Value>
   public void write(DataOutput out)
     throws IOException {
     out.writeInt(this.kvMap.size());
-    out.writeUTF(this.kClass.getName());
-    out.writeUTF(this.vClass.getName());
+    WritableRegistry.get().writeClass(out,
+      this.kClass);
+    WritableRegistry.get().writeClass(out,
+      this.vClass);
     ObjectIterator<Object2ObjectMap.Entry<K, V>> iterator =
       this.kvMap.object2ObjectEntrySet()
         .fastIterator();
@@ -273,9 +277,9 @@ public abstract class Key2ValKVPartition<K extends Key, V extends Value>
     }
     try {
       this.kClass =
-        Writable.forClass(in.readUTF());
+        WritableRegistry.get().readClass(in);
       this.vClass =
-        Writable.forClass(in.readUTF());
+        WritableRegistry.get().readClass(in);
       for (int i = 0; i < size; i++) {
         K key = null;
         V val = null;
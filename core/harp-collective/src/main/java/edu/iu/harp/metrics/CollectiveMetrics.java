@@ -0,0 +1,499 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.metrics;
+
+import org.apache.log4j.Logger;
+
+import java.io.BufferedWriter;
+import java.io.IOException;
+import java.io.OutputStream;
+import java.io.OutputStreamWriter;
+import java.io.Writer;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.HashMap;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/*******************************************************
+ * Always-on metrics of the collective
+ * operations, keyed by the context name and the
+ * operation name. Trailing iteration numbers are
+ * removed from the operation name, so
+ * "allgather-3" and "allgather-4" share the key
+ * "main/allgather". When tracing is enabled, each
+ * record is also kept as an event with the full
+ * operation name and can be written in the
+ * Chrome trace format.
+ ******************************************************/
+public class CollectiveMetrics {
+
+  private static final Logger LOG =
+    Logger.getLogger(CollectiveMetrics.class);
+
+  public static final int ENCODE = 0;
+  public static final int DECODE = 1;
+  public static final int SEND = 2;
+  public static final int RECEIVE = 3;
+  public static final int WAIT = 4;
+  public static final int COMBINE = 5;
+  public static final int NUM_TYPES = 6;
+  public static final String[] TYPE_NAMES =
+    { "encode", "decode", "send", "receive",
+      "wait", "combine" };
+
+  /** The number of stragglers reported */
+  public static final int NUM_STRAGGLERS = 3;
+  /** The max number of trace events kept */
+  public static final int MAX_TRACE_EVENTS =
+    1 << 20;
+  private static final String UNKNOWN_KEY =
+    "unknown";
+
+  private static final CollectiveMetrics instance =
+    new CollectiveMetrics();
+
+  private final ConcurrentHashMap<String, OpMetrics> opMetrics;
+  // The key of the last wait on this thread,
+  // used by the combining after it
+  private final ThreadLocal<String> currentKey;
+  private final ConcurrentLinkedQueue<TraceEvent> traceEvents;
+  private final AtomicInteger numTraceEvents;
+  private volatile boolean isTracing;
+  private volatile long startNanos;
+  private volatile long startMicros;
+
+  /**
+   * One complete event in the trace
+   */
+  private static class TraceEvent {
+    private final String name;
+    private final int type;
+    private final long threadID;
+    private final long startTime;
+    private final long endTime;
+    private final long bytes;
+
+    private TraceEvent(String name, int type,
+      long threadID, long startTime, long endTime,
+      long bytes) {
+      this.name = name;
+      this.type = type;
+      this.threadID = threadID;
+      this.startTime = startTime;
+      this.endTime = endTime;
+      this.bytes = bytes;
+    }
+  }
+
+  private CollectiveMetrics() {
+    opMetrics = new ConcurrentHashMap<>();
+    currentKey = new ThreadLocal<>();
+    traceEvents = new ConcurrentLinkedQueue<>();
+    numTraceEvents = new AtomicInteger(0);
+    isTracing = false;
+    startNanos = System.nanoTime();
+    startMicros =
+      System.currentTimeMillis() * 1000L;
+  }
+
+  /**
+   * Get the metrics
+   *
+   * @return the metrics
+   */
+  public static CollectiveMetrics get() {
+    return instance;
+  }
+
+  /**
+   * Remove all the records and set the time
+   * origin of the trace
+   */
+  public void reset() {
+    opMetrics.clear();
+    traceEvents.clear();
+    numTraceEvents.set(0);
+    startNanos = System.nanoTime();
+    startMicros =
+      System.currentTimeMillis() * 1000L;
+  }
+
+  /**
+   * Enable or disable the trace events
+   *
+   * @param isTracing
+   *          if the events are kept
+   */
+  public void setTracing(boolean isTracing) {
+    this.isTracing = isTracing;
+  }
+
+  public boolean isTracing() {
+    return isTracing;
+  }
+
+  /**
+   * Get the key of the context and the operation
+   *
+   * @param contextName
+   *          the context name
+   * @param operationName
+   *          the operation name, can be null
+   * @return "context/operation" without the
+   *         trailing iteration number
+   */
+  public static String getKey(String contextName,
+    String operationName) {
+    if (contextName == null) {
+      return UNKNOWN_KEY;
+    }
+    if (operationName == null) {
+      return contextName;
+    }
+    int end = operationName.length();
+    while (end > 0) {
+      char c = operationName.charAt(end - 1);
+      if (Character.isDigit(c) || c == '-'
+        || c == '_') {
+        end--;
+      } else {
+        break;
+      }
+    }
+    if (end == 0) {
+      end = operationName.length();
+    }
+    return contextName + "/"
+      + operationName.substring(0, end);
+  }
+
+  /**
+   * Record a timed step of an operation
+   *
+   * @param contextName
+   *          the context name
+   * @param operationName
+   *          the operation name
+   * @param type
+   *          ENCODE, DECODE, SEND or WAIT...
+   * @param bytes
+   *          the bytes handled
+   * @param startTime
+   *          the start time from System.nanoTime
+   * @param endTime
+   *          the end time from System.nanoTime
+   */
+  public void record(String contextName,
+    String operationName, int type, long bytes,
+    long startTime, long endTime) {
+    String key = getKey(contextName, operationName);
+    getOpMetrics(key).add(type, bytes,
+      endTime - startTime);
+    if (isTracing) {
+      addTraceEvent(operationName == null ? key
+        : contextName + "/" + operationName, type,
+        startTime, endTime, bytes);
+    }
+  }
+
+  /**
+   * Record the bytes received for an operation
+   *
+   * @param contextName
+   *          the context name
+   * @param operationName
+   *          the operation name
+   * @param bytes
+   *          the bytes received
+   */
+  public void recordReceive(String contextName,
+    String operationName, long bytes) {
+    getOpMetrics(getKey(contextName, operationName))
+      .add(RECEIVE, bytes, 0L);
+  }
+
+  /**
+   * Record a wait for the data of an operation.
+   * The wait time is charged to the source
+   * worker of the data, and the key is kept for
+   * the combining on this thread.
+   *
+   * @param contextName
+   *          the context name
+   * @param operationName
+   *          the operation name
+   * @param workerID
+   *          the source worker of the data,
+   *          Constant.UNKNOWN_WORKER_ID if the
+   *          wait timed out
+   * @param startTime
+   *          the start time
+   * @param endTime
+   *          the end time
+   */
+  public void recordWait(String contextName,
+    String operationName, int workerID,
+    long startTime, long endTime) {
+    String key = getKey(contextName, operationName);
+    OpMetrics metrics = getOpMetrics(key);
+    metrics.add(WAIT, 0L, endTime - startTime);
+    metrics.addWait(workerID, endTime - startTime);
+    currentKey.set(key);
+    if (isTracing) {
+      addTraceEvent(contextName + "/" + operationName,
+        WAIT, startTime, endTime, 0L);
+    }
+  }
+
+  /**
+   * Record the combining of received partitions.
+   * It is charged to the last operation waited
+   * on this thread.
+   *
+   * @param startTime
+   *          the start time
+   * @param endTime
+   *          the end time
+   */
+  public void recordCombine(long startTime,
+    long endTime) {
+    String key = currentKey.get();
+    if (key == null) {
+      key = UNKNOWN_KEY;
+    }
+    getOpMetrics(key).add(COMBINE, 0L,
+      endTime - startTime);
+    if (isTracing) {
+      addTraceEvent(key, COMBINE, startTime,
+        endTime, 0L);
+    }
+  }
+
+  private OpMetrics getOpMetrics(String key) {
+    OpMetrics metrics = opMetrics.get(key);
+    if (metrics == null) {
+      metrics = new OpMetrics(key);
+      OpMetrics old =
+        opMetrics.putIfAbsent(key, metrics);
+      if (old != null) {
+        metrics = old;
+      }
+    }
+    return metrics;
+  }
+
+  private void addTraceEvent(String name,
+    int type, long startTime, long endTime,
+    long bytes) {
+    if (numTraceEvents
+      .incrementAndGet() <= MAX_TRACE_EVENTS) {
+      traceEvents.add(new TraceEvent(name, type,
+        Thread.currentThread().getId(), startTime,
+        endTime, bytes));
+    }
+  }
+
+  /**
+   * Get the metrics of all the keys
+   *
+   * @return the metrics sorted by key
+   */
+  public List<OpMetrics> getOpMetrics() {
+    return new ArrayList<>(
+      new TreeMap<>(opMetrics).values());
+  }
+
+  /**
+   * Get the metrics of the keys with the most
+   * time spent
+   *
+   * @param num
+   *          the max number of keys
+   * @return the metrics in descending order of
+   *         time
+   */
+  public List<OpMetrics> getTopOpMetrics(int num) {
+    List<OpMetrics> metrics = getOpMetrics();
+    Collections.sort(metrics,
+      (m1, m2) -> Long.compare(m2.getTotalNanos(),
+        m1.getTotalNanos()));
+    if (metrics.size() > num) {
+      return new ArrayList<>(
+        metrics.subList(0, num));
+    }
+    return metrics;
+  }
+
+  /**
+   * Get the nanoseconds of a type over all the
+   * keys
+   *
+   * @param type
+   *          the type
+   * @return the nanoseconds
+   */
+  public long getTotalNanos(int type) {
+    long total = 0L;
+    for (OpMetrics metrics : opMetrics.values()) {
+      total += metrics.getNanos(type);
+    }
+    return total;
+  }
+
+  /**
+   * Get the bytes of a type over all the keys
+   *
+   * @param type
+   *          the type
+   * @return the bytes
+   */
+  public long getTotalBytes(int type) {
+    long total = 0L;
+    for (OpMetrics metrics : opMetrics.values()) {
+      total += metrics.getBytes(type);
+    }
+    return total;
+  }
+
+  /**
+   * Get the workers this worker waited for the
+   * longest over all the keys
+   *
+   * @param num
+   *          the max number of workers
+   * @return a map from worker ID to wait
+   *         nanoseconds, in descending order
+   */
+  public Map<Integer, Long> getStragglers(int num) {
+    Map<Integer, Long> waitNanos = new HashMap<>();
+    for (OpMetrics metrics : opMetrics.values()) {
+      for (Map.Entry<Integer, Long> entry : metrics
+        .getWaitNanos().entrySet()) {
+        waitNanos.merge(entry.getKey(),
+          entry.getValue(), Long::sum);
+      }
+    }
+    Map<Integer, Long> stragglers =
+      new LinkedHashMap<>();
+    for (int workerID : getTopWorkers(waitNanos,
+      num)) {
+      stragglers.put(workerID,
+        waitNanos.get(workerID));
+    }
+    return stragglers;
+  }
+
+  static List<Integer> getTopWorkers(
+    Map<Integer, Long> waitNanos, int num) {
+    List<Map.Entry<Integer, Long>> entries =
+      new ArrayList<>(waitNanos.entrySet());
+    Collections.sort(entries,
+      (e1, e2) -> Long.compare(e2.getValue(),
+        e1.getValue()));
+    List<Integer> workerIDs = new ArrayList<>();
+    for (int i = 0; i < entries.size()
+      && i < num; i++) {
+      workerIDs.add(entries.get(i).getKey());
+    }
+    return workerIDs;
+  }
+
+  /**
+   * Log the metrics of all the keys
+   */
+  public void log() {
+    for (OpMetrics metrics : getOpMetrics()) {
+      LOG.info(metrics);
+    }
+    if (numTraceEvents.get() > MAX_TRACE_EVENTS) {
+      LOG.info("Trace events dropped: "
+        + (numTraceEvents.get() - MAX_TRACE_EVENTS));
+    }
+  }
+
+  /**
+   * Write the trace events in the Chrome trace
+   * JSON format. Timestamps are in microseconds
+   * from the epoch, so the files of all the
+   * workers can be loaded together.
+   *
+   * @param out
+   *          the output stream, closed after
+   *          writing
+   * @param workerID
+   *          the worker ID used as the process ID
+   * @throws IOException
+   */
+  public void writeTrace(OutputStream out,
+    int workerID) throws IOException {
+    Writer writer =
+      new BufferedWriter(new OutputStreamWriter(out,
+        StandardCharsets.UTF_8));
+    try {
+      writer.write("{\"traceEvents\":[\n");
+      writer.write("{\"name\":\"process_name\","
+        + "\"ph\":\"M\",\"pid\":" + workerID
+        + ",\"args\":{\"name\":\"worker "
+        + workerID + "\"}}");
+      for (TraceEvent event : traceEvents) {
+        writer.write(",\n{\"name\":\"");
+        writeEscaped(writer, event.name);
+        writer.write("\",\"cat\":\""
+          + TYPE_NAMES[event.type]
+          + "\",\"ph\":\"X\",\"ts\":"
+          + toMicros(event.startTime) + ",\"dur\":"
+          + ((event.endTime - event.startTime)
+            / 1000L)
+          + ",\"pid\":" + workerID + ",\"tid\":"
+          + event.threadID
+          + ",\"args\":{\"bytes\":" + event.bytes
+          + "}}");
+      }
+      writer.write("\n],\"displayTimeUnit\":\"ms\"}\n");
+    } finally {
+      writer.close();
+    }
+  }
+
+  private long toMicros(long nanoTime) {
+    return startMicros
+      + (nanoTime - startNanos) / 1000L;
+  }
+
+  private static void writeEscaped(Writer writer,
+    String str) throws IOException {
+    for (int i = 0; i < str.length(); i++) {
+      char c = str.charAt(i);
+      if (c == '"' || c == '\\') {
+        writer.write('\\');
+        writer.write(c);
+      } else if (c < 0x20) {
+        writer.write(
+          String.format("\\u%04x", (int) c));
+      } else {
+        writer.write(c);
+      }
+    }
+  }
+}
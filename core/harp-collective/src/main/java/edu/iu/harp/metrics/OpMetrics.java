@@ -0,0 +1,177 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.metrics;
+
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.atomic.LongAdder;
+
+/*******************************************************
+ * The metrics of one context/operation key. All
+ * the counters are LongAdders so the send,
+ * receive and compute threads can update them
+ * without locking.
+ ******************************************************/
+public class OpMetrics {
+
+  private final String key;
+  private final LongAdder[] nanos;
+  private final LongAdder[] bytes;
+  private final LongAdder[] counts;
+  // The wait time charged to each source worker
+  private final ConcurrentHashMap<Integer, LongAdder> waitNanos;
+
+  OpMetrics(String key) {
+    this.key = key;
+    nanos =
+      new LongAdder[CollectiveMetrics.NUM_TYPES];
+    bytes =
+      new LongAdder[CollectiveMetrics.NUM_TYPES];
+    counts =
+      new LongAdder[CollectiveMetrics.NUM_TYPES];
+    for (int i = 0; i < nanos.length; i++) {
+      nanos[i] = new LongAdder();
+      bytes[i] = new LongAdder();
+      counts[i] = new LongAdder();
+    }
+    waitNanos = new ConcurrentHashMap<>();
+  }
+
+  void add(int type, long numBytes,
+    long numNanos) {
+    nanos[type].add(numNanos);
+    bytes[type].add(numBytes);
+    counts[type].increment();
+  }
+
+  void addWait(int workerID, long numNanos) {
+    LongAdder adder = waitNanos.get(workerID);
+    if (adder == null) {
+      adder = new LongAdder();
+      LongAdder old =
+        waitNanos.putIfAbsent(workerID, adder);
+      if (old != null) {
+        adder = old;
+      }
+    }
+    adder.add(numNanos);
+  }
+
+  /**
+   * Get the key, "context/operation"
+   *
+   * @return the key
+   */
+  public String getKey() {
+    return key;
+  }
+
+  /**
+   * Get the nanoseconds spent
+   *
+   * @param type
+   *          the type, e.g.
+   *          CollectiveMetrics.ENCODE
+   * @return the nanoseconds
+   */
+  public long getNanos(int type) {
+    return nanos[type].sum();
+  }
+
+  /**
+   * Get the bytes handled
+   *
+   * @param type
+   *          the type
+   * @return the bytes
+   */
+  public long getBytes(int type) {
+    return bytes[type].sum();
+  }
+
+  /**
+   * Get the number of records
+   *
+   * @param type
+   *          the type
+   * @return the number of records
+   */
+  public long getCount(int type) {
+    return counts[type].sum();
+  }
+
+  /**
+   * Get the total nanoseconds of all the types
+   *
+   * @return the nanoseconds
+   */
+  public long getTotalNanos() {
+    long total = 0L;
+    for (LongAdder adder : nanos) {
+      total += adder.sum();
+    }
+    return total;
+  }
+
+  /**
+   * Get the wait nanoseconds charged to each
+   * source worker. The wait ended by the data
+   * from a worker is charged to the worker.
+   *
+   * @return a map from worker ID to nanoseconds
+   */
+  public Map<Integer, Long> getWaitNanos() {
+    Map<Integer, Long> result =
+      new ConcurrentHashMap<>();
+    for (Map.Entry<Integer, LongAdder> entry : waitNanos
+      .entrySet()) {
+      result.put(entry.getKey(),
+        entry.getValue().sum());
+    }
+    return result;
+  }
+
+  /**
+   * Get the workers this worker waited for the
+   * longest, in descending order of wait time
+   *
+   * @param num
+   *          the max number of workers
+   * @return the worker IDs
+   */
+  public List<Integer> getStragglers(int num) {
+    return CollectiveMetrics
+      .getTopWorkers(getWaitNanos(), num);
+  }
+
+  @Override
+  public String toString() {
+    StringBuilder sb = new StringBuilder(key);
+    for (int i = 0; i < nanos.length; i++) {
+      sb.append(", ")
+        .append(CollectiveMetrics.TYPE_NAMES[i])
+        .append(": ").append(getCount(i))
+        .append(" times, ").append(getNanos(i))
+        .append(" ns, ").append(getBytes(i))
+        .append(" bytes");
+    }
+    sb.append(", stragglers: ").append(
+      getStragglers(CollectiveMetrics.NUM_STRAGGLERS));
+    return sb.toString();
+  }
+}
@@ -0,0 +1,4 @@
+/**
+ * harp collective metrics and tracing
+ */
+package edu.iu.harp.metrics;
\ No newline at end of file
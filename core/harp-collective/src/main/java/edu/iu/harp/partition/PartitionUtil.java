@@ -24,6 +24,7 @@ import edu.iu.harp.io.DataMap;
 import edu.iu.harp.io.DataType;
 import edu.iu.harp.io.DataUtil;
 import edu.iu.harp.io.IOUtil;
+import edu.iu.harp.metrics.CollectiveMetrics;
 import edu.iu.harp.resource.Simple;
 import edu.iu.harp.resource.Transferable;
 import edu.iu.harp.resource.Writable;
@@ -92,6 +93,7 @@ public class PartitionUtil {
   public static <P extends Simple> void addPartitionsToTable(
       List<Transferable> partitions,
       Table<P> table) {
+    long startTime = System.nanoTime();
     Int2ObjectOpenHashMap<List<Partition<P>>> combineMap =
         new Int2ObjectOpenHashMap<>();
     for (Transferable obj : partitions) {
@@ -127,6 +129,8 @@ public class PartitionUtil {
       });
     }
     partitions.clear();
+    CollectiveMetrics.get().recordCombine(
+        startTime, System.nanoTime());
   }
 
   public static <P extends Simple> boolean regroupPartitionCount(String contextName,
@@ -37,6 +37,10 @@ public abstract class ArrayPool<T> {
     Logger.getLogger(ArrayPool.class);
   /* A map from size to ArrayStore */
   private Int2ObjectOpenHashMap<ArrayStore> arrayMap;
+  /* The usage statistics */
+  private long numHits;
+  private long numMisses;
+  private long numRetainedBytes;
 
   /**
    * ArrayStore is used for buffering Arrays.
@@ -56,6 +60,9 @@ public abstract class ArrayPool<T> {
 
   public ArrayPool() {
     arrayMap = new Int2ObjectOpenHashMap<>();
+    numHits = 0L;
+    numMisses = 0L;
+    numRetainedBytes = 0L;
   }
 
   /**
@@ -99,6 +106,17 @@ public abstract class ArrayPool<T> {
    */
   protected abstract int getLength(T array);
 
+  /**
+   * Get the number of bytes of the array. By
+   * default, one byte per element.
+   * 
+   * @param array
+   * @return the number of bytes
+   */
+  protected long getNumBytes(T array) {
+    return getLength(array);
+  }
+
   /**
    * If approximate is false, get an array of
    * required size. else, get an array of adjusted
@@ -128,6 +146,7 @@ public abstract class ArrayPool<T> {
       arrayMap.put(adjustSize, arrayStore);
     }
     if (arrayStore.freeQueue.isEmpty()) {
+      numMisses++;
       try {
         T array = createNewArray(adjustSize);
         arrayStore.inUseSet.add(array);
@@ -155,6 +174,8 @@ public abstract class ArrayPool<T> {
       T array =
         arrayStore.freeQueue.removeFirst();
       arrayStore.inUseSet.add(array);
+      numHits++;
+      numRetainedBytes -= getNumBytes(array);
       // LOG
       // .info("Get an existing array with
       // adjusted size: "
@@ -192,6 +213,7 @@ public abstract class ArrayPool<T> {
     } else {
       if (arrayStore.inUseSet.remove(array)) {
         arrayStore.freeQueue.add(array);
+        numRetainedBytes += getNumBytes(array);
         return true;
       } else {
         // LOG
@@ -235,6 +257,37 @@ public abstract class ArrayPool<T> {
     for (ArrayStore store : arrayMap.values()) {
       store.freeQueue.clear();
     }
+    numRetainedBytes = 0L;
+  }
+
+  /**
+   * Get the number of requests served by cached
+   * arrays
+   * 
+   * @return the number of hits
+   */
+  synchronized long getNumHits() {
+    return numHits;
+  }
+
+  /**
+   * Get the number of requests which allocated
+   * new arrays
+   * 
+   * @return the number of misses
+   */
+  synchronized long getNumMisses() {
+    return numMisses;
+  }
+
+  /**
+   * Get the number of bytes held by the cached
+   * not-in-use arrays
+   * 
+   * @return the number of bytes
+   */
+  synchronized long getNumRetainedBytes() {
+    return numRetainedBytes;
   }
 
   /**
@@ -41,4 +41,12 @@ public class DoublesPool
   protected int getLength(double[] array) {
     return array.length;
   }
+
+  /**
+   * Get the number of bytes of the array
+   */
+  @Override
+  protected long getNumBytes(double[] array) {
+    return (long) array.length * 8;
+  }
 }
@@ -41,4 +41,12 @@ public class FloatsPool
   protected int getLength(float[] array) {
     return array.length;
   }
+
+  /**
+   * Get the number of bytes of the array
+   */
+  @Override
+  protected long getNumBytes(float[] array) {
+    return (long) array.length * 4;
+  }
 }
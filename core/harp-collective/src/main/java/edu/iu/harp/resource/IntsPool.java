@@ -40,4 +40,12 @@ public class IntsPool extends ArrayPool<int[]> {
   protected int getLength(int[] array) {
     return array.length;
   }
+
+  /**
+   * Get the number of bytes of the array
+   */
+  @Override
+  protected long getNumBytes(int[] array) {
+    return (long) array.length * 4;
+  }
 }
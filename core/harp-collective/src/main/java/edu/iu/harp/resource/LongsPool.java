@@ -40,4 +40,12 @@ public class LongsPool extends ArrayPool<long[]> {
   protected int getLength(long[] array) {
     return array.length;
   }
+
+  /**
+   * Get the number of bytes of the array
+   */
+  @Override
+  protected long getNumBytes(long[] array) {
+    return (long) array.length * 8;
+  }
 }
@@ -92,6 +92,51 @@ public class ResourcePool {
     writables.clean();
   }
 
+  /**
+   * Get the number of array requests served by
+   * the cached arrays in all the array pools
+   * 
+   * @return the number of hits
+   */
+  public long getNumArrayHits() {
+    return byteArrays.getNumHits()
+      + shortArrays.getNumHits()
+      + intArrays.getNumHits()
+      + floatArrays.getNumHits()
+      + longArrays.getNumHits()
+      + doubleArrays.getNumHits();
+  }
+
+  /**
+   * Get the number of array requests which
+   * allocated new arrays in all the array pools
+   * 
+   * @return the number of misses
+   */
+  public long getNumArrayMisses() {
+    return byteArrays.getNumMisses()
+      + shortArrays.getNumMisses()
+      + intArrays.getNumMisses()
+      + floatArrays.getNumMisses()
+      + longArrays.getNumMisses()
+      + doubleArrays.getNumMisses();
+  }
+
+  /**
+   * Get the number of bytes held by the cached
+   * arrays in all the array pools
+   * 
+   * @return the number of bytes
+   */
+  public long getNumRetainedBytes() {
+    return byteArrays.getNumRetainedBytes()
+      + shortArrays.getNumRetainedBytes()
+      + intArrays.getNumRetainedBytes()
+      + floatArrays.getNumRetainedBytes()
+      + longArrays.getNumRetainedBytes()
+      + doubleArrays.getNumRetainedBytes();
+  }
+
   public void log() {
     byteArrays.log();
     shortArrays.log();
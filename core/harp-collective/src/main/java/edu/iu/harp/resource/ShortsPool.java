@@ -41,4 +41,12 @@ public class ShortsPool
   protected int getLength(short[] array) {
     return array.length;
   }
+
+  /**
+   * Get the number of bytes of the array
+   */
+  @Override
+  protected long getNumBytes(short[] array) {
+    return (long) array.length * 2;
+  }
 }
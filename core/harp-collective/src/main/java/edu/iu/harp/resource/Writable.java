@@ -21,8 +21,6 @@ import edu.iu.harp.io.DataType;
 import java.io.DataInput;
 import java.io.DataOutput;
 import java.io.IOException;
-import java.lang.reflect.Constructor;
-import java.lang.reflect.InvocationTargetException;
 
 /*******************************************************
  * ByteArray class for managing writable objects.
@@ -35,18 +33,22 @@ public abstract class Writable extends Simple {
   @Override
   public final int getNumEnocdeBytes() {
     return 1
-      + this.getClass().getName().length() * 2 + 4
+      + WritableRegistry.get()
+        .getNumClassBytes(this.getClass())
       + getNumWriteBytes();
   }
 
   /**
-   * Encode the writable as DataOutput
+   * Encode the writable as DataOutput. The class
+   * is written as an ID if it is registered in
+   * WritableRegistry, or as its name.
    */
   @Override
   public final void encode(DataOutput out)
     throws IOException {
     out.writeByte(DataType.WRITABLE);
-    out.writeUTF(this.getClass().getName());
+    WritableRegistry.get().writeClass(out,
+      this.getClass());
     this.write(out);
   }
 
@@ -57,18 +59,8 @@ public abstract class Writable extends Simple {
    */
   public final static <W extends Writable> W
     newInstance(Class<W> clazz) {
-    try {
-      Constructor<W> constructor =
-        clazz.getConstructor();
-      return constructor.newInstance();
-    } catch (InstantiationException |
-      IllegalAccessException |
-      IllegalArgumentException |
-      InvocationTargetException |
-      NoSuchMethodException |
-      SecurityException e) {
-      return null;
-    }
+    return WritableRegistry.get()
+      .newInstance(clazz);
   }
 
   /**
@@ -92,11 +84,8 @@ public abstract class Writable extends Simple {
    */
   public final static <W extends Writable>
     Class<W> forClass(String className) {
-    try {
-      return (Class<W>) Class.forName(className);
-    } catch (ClassNotFoundException e) {
-      return null;
-    }
+    return WritableRegistry.get()
+      .forName(className);
   }
 
   /**
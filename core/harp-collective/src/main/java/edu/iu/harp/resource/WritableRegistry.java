@@ -0,0 +1,358 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.resource;
+
+import org.apache.log4j.Logger;
+
+import java.io.DataInput;
+import java.io.DataOutput;
+import java.io.IOException;
+import java.lang.reflect.Constructor;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.ConcurrentHashMap;
+
+/*******************************************************
+ * The registry of Writable classes. A registered
+ * class is encoded as a two-byte class ID
+ * instead of its class name. IDs are assigned in
+ * the order of registration and never reused,
+ * so all the workers must register the same
+ * classes in the same order before a barrier,
+ * then data encoded with either form can be
+ * decoded everywhere. The registry also caches
+ * the class objects and the constructors used
+ * to create Writables during decoding.
+ ******************************************************/
+public class WritableRegistry {
+
+  private static final Logger LOG =
+    Logger.getLogger(WritableRegistry.class);
+
+  /** The class ID written before a class name */
+  public static final short UNREGISTERED = -1;
+  /** The max number of registered classes */
+  public static final int MAX_NUM_CLASSES =
+    Short.MAX_VALUE;
+  /**
+   * The min number of partitions in a list
+   * encoded as a batch. With three or more, a
+   * batch is never larger than the partitions
+   * encoded one by one.
+   */
+  public static final int MIN_BATCH_SIZE = 3;
+
+  private static final WritableRegistry instance =
+    new WritableRegistry();
+
+  private final ConcurrentHashMap<Class<?>, Integer> classIDs;
+  private volatile Class<? extends Writable>[] idClasses;
+  private final ConcurrentHashMap<String, Class<? extends Writable>> nameClasses;
+  private final ConcurrentHashMap<Class<?>, Constructor<?>> constructors;
+  private volatile boolean useBatch;
+
+  @SuppressWarnings("unchecked")
+  WritableRegistry() {
+    classIDs = new ConcurrentHashMap<>();
+    idClasses = new Class[0];
+    nameClasses = new ConcurrentHashMap<>();
+    constructors = new ConcurrentHashMap<>();
+    useBatch = true;
+  }
+
+  /**
+   * Get the registry
+   *
+   * @return the registry
+   */
+  public static WritableRegistry get() {
+    return instance;
+  }
+
+  /**
+   * Register a class. If the class is registered,
+   * return the existing ID.
+   *
+   * @param clazz
+   *          the class
+   * @return the class ID
+   */
+  @SuppressWarnings("unchecked")
+  public synchronized int
+    register(Class<? extends Writable> clazz) {
+    Integer classID = classIDs.get(clazz);
+    if (classID != null) {
+      return classID;
+    }
+    if (idClasses.length == MAX_NUM_CLASSES) {
+      throw new IllegalStateException(
+        "Too many Writable classes.");
+    }
+    Class<? extends Writable>[] newClasses =
+      new Class[idClasses.length + 1];
+    System.arraycopy(idClasses, 0, newClasses, 0,
+      idClasses.length);
+    newClasses[idClasses.length] = clazz;
+    // Publish the array before the ID
+    idClasses = newClasses;
+    classIDs.put(clazz, newClasses.length - 1);
+    return newClasses.length - 1;
+  }
+
+  /**
+   * Register the classes with the given names in
+   * order.
+   *
+   * @param classNames
+   *          the class names
+   * @return false if a class cannot be loaded or
+   *         is not a Writable
+   */
+  public boolean
+    register(List<String> classNames) {
+    for (String className : classNames) {
+      Class<? extends Writable> clazz =
+        forName(className);
+      if (clazz == null) {
+        LOG.error("Cannot load Writable class "
+          + className);
+        return false;
+      }
+      register(clazz);
+    }
+    return true;
+  }
+
+  /**
+   * Remove all the registered classes
+   */
+  @SuppressWarnings("unchecked")
+  public synchronized void reset() {
+    classIDs.clear();
+    idClasses = new Class[0];
+  }
+
+  /**
+   * Get the number of registered classes
+   *
+   * @return the number of registered classes
+   */
+  public int getNumClasses() {
+    return idClasses.length;
+  }
+
+  /**
+   * Get the registered class names in the order
+   * of the class IDs
+   *
+   * @return the class names
+   */
+  public List<String> getClassNames() {
+    Class<? extends Writable>[] classes =
+      idClasses;
+    List<String> classNames =
+      new ArrayList<>(classes.length);
+    for (Class<? extends Writable> clazz : classes) {
+      classNames.add(clazz.getName());
+    }
+    return classNames;
+  }
+
+  /**
+   * Get a hash of the registered class names in
+   * the order of the class IDs. Two registries
+   * decode the same IDs to the same classes only
+   * if their hashes match.
+   *
+   * @return the 64-bit FNV-1a hash
+   */
+  public long getClassHash() {
+    long hash = 0xcbf29ce484222325L;
+    for (String className : getClassNames()) {
+      for (int i = 0; i < className.length(); i++) {
+        hash ^= className.charAt(i);
+        hash *= 0x100000001b3L;
+      }
+      // Separate the names
+      hash ^= '\n';
+      hash *= 0x100000001b3L;
+    }
+    return hash;
+  }
+
+  /**
+   * Get the class ID
+   *
+   * @param clazz
+   *          the class
+   * @return the class ID or UNREGISTERED
+   */
+  public int getClassID(Class<?> clazz) {
+    Integer classID = classIDs.get(clazz);
+    if (classID == null) {
+      return UNREGISTERED;
+    } else {
+      return classID;
+    }
+  }
+
+  /**
+   * Enable or disable the batch encoding of
+   * partition lists
+   *
+   * @param useBatch
+   *          if the batch encoding is used
+   */
+  public void setUseBatch(boolean useBatch) {
+    this.useBatch = useBatch;
+  }
+
+  /**
+   * Check if the batch encoding is used
+   *
+   * @return true if used
+   */
+  public boolean useBatch() {
+    return useBatch;
+  }
+
+  /**
+   * Get the number of bytes of an encoded class.
+   * For an unregistered class, the name length
+   * is estimated the same way as before.
+   *
+   * @param clazz
+   *          the class
+   * @return the number of bytes
+   */
+  public int getNumClassBytes(Class<?> clazz) {
+    if (classIDs.containsKey(clazz)) {
+      return 2;
+    } else {
+      return 2 + clazz.getName().length() * 2
+        + 4;
+    }
+  }
+
+  /**
+   * Write the class ID, or UNREGISTERED and the
+   * class name
+   *
+   * @param out
+   *          the DataOutput
+   * @param clazz
+   *          the class
+   * @throws IOException
+   */
+  public void writeClass(DataOutput out,
+    Class<?> clazz) throws IOException {
+    Integer classID = classIDs.get(clazz);
+    if (classID != null) {
+      out.writeShort(classID);
+    } else {
+      out.writeShort(UNREGISTERED);
+      out.writeUTF(clazz.getName());
+    }
+  }
+
+  /**
+   * Read a class written by writeClass
+   *
+   * @param in
+   *          the DataInput
+   * @return the class
+   * @throws IOException
+   *           if the class is unknown
+   */
+  public <W extends Writable> Class<W>
+    readClass(DataInput in) throws IOException {
+    short classID = in.readShort();
+    if (classID == UNREGISTERED) {
+      String className = in.readUTF();
+      Class<W> clazz = forName(className);
+      if (clazz == null) {
+        throw new IOException(
+          "Unknown Writable class " + className);
+      }
+      return clazz;
+    }
+    Class<? extends Writable>[] classes =
+      idClasses;
+    if (classID < 0 || classID >= classes.length) {
+      throw new IOException(
+        "Unknown Writable class ID " + classID);
+    }
+    @SuppressWarnings("unchecked")
+    Class<W> clazz = (Class<W>) classes[classID];
+    return clazz;
+  }
+
+  /**
+   * Get the Writable class with the given name.
+   * The result is cached.
+   *
+   * @param className
+   *          the class name
+   * @return the class or null if it cannot be
+   *         loaded or is not a Writable
+   */
+  @SuppressWarnings("unchecked")
+  public <W extends Writable> Class<W>
+    forName(String className) {
+    Class<? extends Writable> clazz =
+      nameClasses.get(className);
+    if (clazz == null) {
+      Class<?> loaded = null;
+      try {
+        loaded = Class.forName(className);
+      } catch (ClassNotFoundException e) {
+        return null;
+      }
+      if (!Writable.class.isAssignableFrom(loaded)) {
+        LOG.error(className + " is not a Writable.");
+        return null;
+      }
+      clazz = (Class<? extends Writable>) loaded;
+      nameClasses.put(className, clazz);
+    }
+    return (Class<W>) clazz;
+  }
+
+  /**
+   * Create a new instance with the cached
+   * no-argument constructor
+   *
+   * @param clazz
+   *          the class
+   * @return the new instance or null
+   */
+  @SuppressWarnings("unchecked")
+  public <W extends Writable> W
+    newInstance(Class<W> clazz) {
+    try {
+      Constructor<W> constructor =
+        (Constructor<W>) constructors.get(clazz);
+      if (constructor == null) {
+        constructor = clazz.getConstructor();
+        constructors.put(clazz, constructor);
+      }
+      return constructor.newInstance();
+    } catch (Exception e) {
+      return null;
+    }
+  }
+}
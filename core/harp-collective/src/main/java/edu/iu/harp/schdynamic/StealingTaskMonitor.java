@@ -0,0 +1,236 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.schdynamic;
+
+import org.apache.log4j.Logger;
+
+import java.util.concurrent.ConcurrentLinkedDeque;
+import java.util.concurrent.Semaphore;
+import java.util.concurrent.ThreadLocalRandom;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.locks.LockSupport;
+
+/*******************************************************
+ * Monitor and manage a task with its own input
+ * deque. The monitor takes inputs from the head
+ * of its own deque and steals from the tail of
+ * the other deques when its own deque is empty.
+ ******************************************************/
+public class StealingTaskMonitor<I, O, T extends Task<I, O>>
+  implements Runnable {
+
+  protected static final Logger LOG =
+    Logger.getLogger(StealingTaskMonitor.class);
+
+  // The max time to park when idle
+  private static final long PARK_NANOS =
+    TimeUnit.MILLISECONDS.toNanos(1L);
+
+  private final WorkStealingScheduler<I, O, T> scheduler;
+  private final ConcurrentLinkedDeque<I> inputDeque;
+  private final T taskObject;
+  private final Semaphore barrier1;
+  private final Semaphore barrier2;
+  private volatile Thread thread;
+  private volatile boolean isParked;
+
+  // Counters, only written by the monitor thread
+  private volatile long numTasksRun;
+  private volatile long numSteals;
+  private volatile long idleNanos;
+
+  StealingTaskMonitor(
+    WorkStealingScheduler<I, O, T> scheduler,
+    T task, Semaphore barrier1) {
+    this.scheduler = scheduler;
+    inputDeque = new ConcurrentLinkedDeque<>();
+    taskObject = task;
+    this.barrier1 = barrier1;
+    this.barrier2 = new Semaphore(0);
+    thread = null;
+    isParked = false;
+    numTasksRun = 0L;
+    numSteals = 0L;
+    idleNanos = 0L;
+  }
+
+  /**
+   * Get the input deque owned by this monitor
+   *
+   * @return the input deque
+   */
+  ConcurrentLinkedDeque<I> getInputDeque() {
+    return inputDeque;
+  }
+
+  /**
+   * Release the barrier
+   */
+  void release() {
+    barrier2.release();
+  }
+
+  /**
+   * Wake up the monitor thread if it is parked
+   */
+  void wakeUp() {
+    Thread t = thread;
+    if (isParked && t != null) {
+      LockSupport.unpark(t);
+    }
+  }
+
+  /**
+   * Check if the monitor thread is parked
+   *
+   * @return true if parked, false otherwise
+   */
+  boolean isParked() {
+    return isParked;
+  }
+
+  /**
+   * Get the number of the inputs processed
+   *
+   * @return the number of the inputs processed
+   */
+  public long getNumTasksRun() {
+    return numTasksRun;
+  }
+
+  /**
+   * Get the number of the inputs stolen from the
+   * other monitors
+   *
+   * @return the number of the steals
+   */
+  public long getNumSteals() {
+    return numSteals;
+  }
+
+  /**
+   * Get the time spent on waiting for inputs
+   *
+   * @return the idle time in nanoseconds
+   */
+  public long getIdleNanos() {
+    return idleNanos;
+  }
+
+  /**
+   * Reset the counters
+   */
+  void resetCounters() {
+    numTasksRun = 0L;
+    numSteals = 0L;
+    idleNanos = 0L;
+  }
+
+  /**
+   * Take an input from the own deque, or steal
+   * one from the other monitors
+   *
+   * @return the input, null if no input is found
+   */
+  private I next() {
+    I input = inputDeque.pollFirst();
+    if (input != null) {
+      return input;
+    }
+    StealingTaskMonitor<I, O, T>[] monitors =
+      scheduler.getMonitors();
+    int numMonitors = monitors.length;
+    if (numMonitors > 1) {
+      int start = ThreadLocalRandom.current()
+        .nextInt(numMonitors);
+      for (int i = 0; i < numMonitors; i++) {
+        StealingTaskMonitor<I, O, T> victim =
+          monitors[(start + i) % numMonitors];
+        if (victim != this) {
+          input = victim.inputDeque.pollLast();
+          if (input != null) {
+            numSteals++;
+            return input;
+          }
+        }
+      }
+    }
+    return null;
+  }
+
+  /**
+   * The main process of monitoring and managing
+   * tasks
+   */
+  @Override
+  public void run() {
+    thread = Thread.currentThread();
+    long idleStart = 0L;
+    while (true) {
+      int control = scheduler.getControl();
+      I input = null;
+      if (control != WorkStealingScheduler.PAUSE_NOW) {
+        input = next();
+      }
+      if (input != null) {
+        if (idleStart != 0L) {
+          idleNanos += System.nanoTime() - idleStart;
+          idleStart = 0L;
+        }
+        O output = null;
+        boolean isFailed = false;
+        try {
+          output = taskObject.run(input);
+        } catch (Exception e) {
+          output = null;
+          isFailed = true;
+          LOG.error("Error when processing input",
+            e);
+        }
+        numTasksRun++;
+        scheduler.addOutput(output, isFailed);
+      } else if (control == WorkStealingScheduler.STOP) {
+        break;
+      } else if (control == WorkStealingScheduler.PAUSE
+        || control == WorkStealingScheduler.PAUSE_NOW) {
+        if (idleStart != 0L) {
+          idleNanos += System.nanoTime() - idleStart;
+          idleStart = 0L;
+        }
+        barrier1.release();
+        ComputeUtil.acquire(barrier2);
+      } else {
+        if (idleStart == 0L) {
+          idleStart = System.nanoTime();
+        }
+        // Publish the parked state before
+        // checking the deques again, so the
+        // submitter can see it after adding
+        isParked = true;
+        if (scheduler.getControl() == control
+          && !scheduler.hasQueuedInput()) {
+          LockSupport.parkNanos(this, PARK_NANOS);
+        }
+        isParked = false;
+      }
+    }
+    if (idleStart != 0L) {
+      idleNanos += System.nanoTime() - idleStart;
+    }
+    thread = null;
+  }
+}
@@ -0,0 +1,489 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.schdynamic;
+
+import org.apache.log4j.Logger;
+
+import java.util.Collection;
+import java.util.List;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.Semaphore;
+
+/*******************************************************
+ * The dynamic scheduler with work stealing. It
+ * has the same usage as DynamicScheduler, but each
+ * task has its own input deque. Inputs are
+ * distributed to the deques on submission, and
+ * idle tasks steal inputs from the others. Inputs
+ * and outputs are not wrapped, so fine-grained
+ * tasks don't contend on one queue lock.
+ ******************************************************/
+public class WorkStealingScheduler<I, O, T extends Task<I, O>> {
+
+  protected static final Logger LOG =
+    Logger.getLogger(WorkStealingScheduler.class);
+
+  // Control states read by the task monitors
+  static final int RUNNING = 0;
+  static final int PAUSE = 1;
+  static final int PAUSE_NOW = 2;
+  static final int STOP = 3;
+
+  // Markers in the output queue, which doesn't
+  // take null
+  private static final Object NULL_OUTPUT =
+    new Object();
+  private static final Object ERROR_OUTPUT =
+    new Object();
+
+  private final StealingTaskMonitor<I, O, T>[] taskMonitors;
+  private final ConcurrentLinkedQueue<Object> outputQueue;
+  private final Semaphore outputSem;
+
+  private Thread[] threads;
+  private int inputCount;
+  private int outputCount;
+  private int errorCount;
+  private boolean isRunning;
+  private boolean isPausing;
+  private volatile int control;
+  private int nextMonitor;
+  private final List<T> tasks;
+  private final int numTaskMonitors;
+  private final Semaphore barrier1;
+
+  @SuppressWarnings("unchecked")
+  public WorkStealingScheduler(List<T> tasks) {
+    outputQueue = new ConcurrentLinkedQueue<>();
+    outputSem = new Semaphore(0);
+    threads = null;
+    inputCount = 0;
+    outputCount = 0;
+    errorCount = 0;
+    isRunning = false;
+    isPausing = false;
+    control = RUNNING;
+    nextMonitor = 0;
+    barrier1 = new Semaphore(0);
+    numTaskMonitors = tasks.size();
+    this.tasks = tasks;
+    taskMonitors =
+      new StealingTaskMonitor[numTaskMonitors];
+    int i = 0;
+    for (T task : tasks) {
+      taskMonitors[i++] =
+        new StealingTaskMonitor<>(this, task,
+          barrier1);
+    }
+  }
+
+  /**
+   * Get the list of tasks
+   *
+   * @return the list of tasks
+   */
+  public List<T> getTasks() {
+    return tasks;
+  }
+
+  /**
+   * Get the task monitors
+   *
+   * @return the task monitors
+   */
+  StealingTaskMonitor<I, O, T>[] getMonitors() {
+    return taskMonitors;
+  }
+
+  /**
+   * Get the control state
+   *
+   * @return the control state
+   */
+  int getControl() {
+    return control;
+  }
+
+  /**
+   * Check if any input deque is not empty
+   *
+   * @return true if has queued inputs, false
+   *         otherwise
+   */
+  boolean hasQueuedInput() {
+    for (StealingTaskMonitor<I, O, T> monitor : taskMonitors) {
+      if (!monitor.getInputDeque().isEmpty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Get the number of the queued inputs
+   *
+   * @return the number of the queued inputs
+   */
+  private int getNumQueuedInputs() {
+    int size = 0;
+    for (StealingTaskMonitor<I, O, T> monitor : taskMonitors) {
+      size += monitor.getInputDeque().size();
+    }
+    return size;
+  }
+
+  /**
+   * Add an output, invoked by the task monitors
+   *
+   * @param output
+   *          the output
+   * @param isFailed
+   *          if the task failed
+   */
+  void addOutput(O output, boolean isFailed) {
+    if (isFailed) {
+      outputQueue.add(ERROR_OUTPUT);
+    } else if (output == null) {
+      outputQueue.add(NULL_OUTPUT);
+    } else {
+      outputQueue.add(output);
+    }
+    outputSem.release();
+  }
+
+  /**
+   * Wake up a parked task monitor after new
+   * inputs are added
+   */
+  private void wakeUp(int count) {
+    for (int i = 0; i < numTaskMonitors
+      && count > 0; i++) {
+      if (taskMonitors[i].isParked()) {
+        taskMonitors[i].wakeUp();
+        count--;
+      }
+    }
+  }
+
+  /**
+   * Wake up all the task monitors
+   */
+  private void wakeUpAll() {
+    for (StealingTaskMonitor<I, O, T> monitor : taskMonitors) {
+      monitor.wakeUp();
+    }
+  }
+
+  /**
+   * Submit the input
+   *
+   * @param input
+   *          the input
+   */
+  public synchronized void submit(I input) {
+    if (input != null) {
+      taskMonitors[nextMonitor].getInputDeque()
+        .addLast(input);
+      nextMonitor =
+        (nextMonitor + 1) % numTaskMonitors;
+      if (isRunning) {
+        inputCount++;
+        wakeUp(1);
+      }
+    }
+  }
+
+  /**
+   * Submit a collection of inputs. The inputs are
+   * split into contiguous blocks, one block per
+   * task.
+   *
+   * @param inputs
+   *          a collection of inputs
+   */
+  public synchronized void
+    submitAll(Collection<I> inputs) {
+    int numInputs = inputs.size();
+    int submitCount = 0;
+    for (I input : inputs) {
+      if (input != null) {
+        int monitorID = (int) ((long) submitCount
+          * numTaskMonitors / numInputs);
+        taskMonitors[monitorID].getInputDeque()
+          .addLast(input);
+        submitCount++;
+      }
+    }
+    if (isRunning) {
+      inputCount += submitCount;
+      wakeUp(submitCount);
+    }
+  }
+
+  /**
+   * Submit an array of inputs. The inputs are
+   * split into contiguous blocks, one block per
+   * task.
+   *
+   * @param inputs
+   *          an aray of inputs
+   */
+  public synchronized void submitAll(I[] inputs) {
+    int submitCount = 0;
+    for (int i = 0; i < inputs.length; i++) {
+      if (inputs[i] != null) {
+        int monitorID = (int) ((long) i
+          * numTaskMonitors / inputs.length);
+        taskMonitors[monitorID].getInputDeque()
+          .addLast(inputs[i]);
+        submitCount++;
+      }
+    }
+    if (isRunning) {
+      inputCount += submitCount;
+      wakeUp(submitCount);
+    }
+  }
+
+  /**
+   * Start scheduling
+   */
+  public synchronized void start() {
+    // Start monitor threads, wait for inputs
+    if (!isRunning) {
+      isRunning = true;
+      control = RUNNING;
+      inputCount += getNumQueuedInputs();
+      if (isPausing) {
+        isPausing = false;
+        for (StealingTaskMonitor<I, O, T> monitor : taskMonitors) {
+          monitor.release();
+        }
+      } else {
+        threads = new Thread[numTaskMonitors];
+        for (int i = 0; i < numTaskMonitors; i++) {
+          threads[i] = new Thread(taskMonitors[i]);
+          threads[i].start();
+        }
+      }
+    }
+  }
+
+  /**
+   * Pause the task after all the submitted
+   * inputs are processed
+   */
+  public synchronized void pause() {
+    pause(PAUSE);
+  }
+
+  /**
+   * Pause the task immediately, the inputs not
+   * started are kept in the deques
+   */
+  public synchronized void pauseNow() {
+    pause(PAUSE_NOW);
+  }
+
+  private void pause(int pauseControl) {
+    if (isRunning && !isPausing) {
+      isRunning = false;
+      isPausing = true;
+      control = pauseControl;
+      wakeUpAll();
+      ComputeUtil.acquire(barrier1,
+        numTaskMonitors);
+      inputCount -= getNumQueuedInputs();
+    }
+  }
+
+  /**
+   * Clean the input queue
+   */
+  public synchronized void cleanInputQueue() {
+    if (isPausing || !isRunning) {
+      for (StealingTaskMonitor<I, O, T> monitor : taskMonitors) {
+        monitor.getInputDeque().clear();
+      }
+    }
+  }
+
+  /**
+   * Stop submission, the tasks exit after all the
+   * submitted inputs are processed
+   */
+  public synchronized void stop() {
+    if (isPausing) {
+      start();
+    }
+    if (isRunning) {
+      isRunning = false;
+      control = STOP;
+      wakeUpAll();
+      for (int i = 0; i < numTaskMonitors; i++) {
+        ComputeUtil.joinThread(threads[i]);
+      }
+      threads = null;
+    }
+  }
+
+  /**
+   * Blocked and wait for outputs Invoke as
+   * while(hasOutput()) { waitForOutput(); }
+   *
+   * @return the output
+   */
+  public synchronized O waitForOutput() {
+    // If no output is available, wait for one
+    if (hasNext()) {
+      ComputeUtil.acquire(outputSem);
+      return takeOutput();
+    } else {
+      return null;
+    }
+  }
+
+  /**
+   * Wait for at least one output, then drain all
+   * the available outputs to the collection.
+   * Outputs of the failed tasks are not added.
+   *
+   * @param outputs
+   *          the collection to hold the outputs
+   * @return the number of the outputs taken,
+   *         including the failed ones
+   */
+  public synchronized int
+    drainOutputs(Collection<? super O> outputs) {
+    if (!hasNext()) {
+      return 0;
+    }
+    ComputeUtil.acquire(outputSem);
+    int count = 1 + outputSem.drainPermits();
+    for (int i = 0; i < count; i++) {
+      O output = takeOutput();
+      if (output != null) {
+        outputs.add(output);
+      }
+    }
+    return count;
+  }
+
+  /**
+   * Take an output after a permit is acquired
+   *
+   * @return the output
+   */
+  @SuppressWarnings("unchecked")
+  private O takeOutput() {
+    Object output = outputQueue.poll();
+    outputCount++;
+    if (output == ERROR_OUTPUT) {
+      errorCount++;
+      return null;
+    } else if (output == NULL_OUTPUT) {
+      return null;
+    } else {
+      return (O) output;
+    }
+  }
+
+  /**
+   * Check if has a new output
+   *
+   * @return true if has a new output, false
+   *         otherwise
+   */
+  public synchronized boolean hasOutput() {
+    return hasNext();
+  }
+
+  /**
+   * Check if has next output
+   *
+   * @return true if has next output, false
+   *         otherwise
+   */
+  private boolean hasNext() {
+    return inputCount > outputCount;
+  }
+
+  /**
+   * Check if has errors or not
+   *
+   * @return true if has errors, false otherwise
+   */
+  public synchronized boolean hasError() {
+    int count = errorCount;
+    errorCount = 0;
+    return count > 0;
+  }
+
+  /**
+   * Get the number of the inputs processed by
+   * each task
+   *
+   * @return the numbers of the inputs processed
+   */
+  public long[] getNumTasksRun() {
+    long[] counts = new long[numTaskMonitors];
+    for (int i = 0; i < numTaskMonitors; i++) {
+      counts[i] = taskMonitors[i].getNumTasksRun();
+    }
+    return counts;
+  }
+
+  /**
+   * Get the number of the inputs stolen by each
+   * task
+   *
+   * @return the numbers of the steals
+   */
+  public long[] getNumSteals() {
+    long[] counts = new long[numTaskMonitors];
+    for (int i = 0; i < numTaskMonitors; i++) {
+      counts[i] = taskMonitors[i].getNumSteals();
+    }
+    return counts;
+  }
+
+  /**
+   * Get the time each task spent on waiting for
+   * inputs
+   *
+   * @return the idle time in nanoseconds
+   */
+  public long[] getIdleNanos() {
+    long[] times = new long[numTaskMonitors];
+    for (int i = 0; i < numTaskMonitors; i++) {
+      times[i] = taskMonitors[i].getIdleNanos();
+    }
+    return times;
+  }
+
+  /**
+   * Reset the counters of the tasks. Invoke when
+   * the tasks are paused or stopped.
+   */
+  public synchronized void resetCounters() {
+    if (isPausing || !isRunning) {
+      for (StealingTaskMonitor<I, O, T> monitor : taskMonitors) {
+        monitor.resetCounters();
+      }
+    }
+  }
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.server;
+
+import edu.iu.harp.client.EventType;
+import edu.iu.harp.io.Constant;
+import edu.iu.harp.io.Data;
+import edu.iu.harp.io.DataMap;
+import edu.iu.harp.io.DataUtil;
+import edu.iu.harp.io.EventQueue;
+import edu.iu.harp.resource.ByteArray;
+import org.apache.log4j.Logger;
+
+import java.io.ByteArrayInputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.SequenceInputStream;
+import java.net.Socket;
+import java.nio.ByteBuffer;
+import java.nio.channels.SocketChannel;
+
+/*******************************************************
+ * A connection served by an NIO event loop. It
+ * parses the same wire format as DataReceiver:
+ * command, head array size, head array and body
+ * array. Broadcast commands relay data while
+ * receiving, so these connections are handed
+ * off to a blocking Acceptor thread.
+ ******************************************************/
+class NioConn {
+
+  private static final Logger LOG =
+    Logger.getLogger(NioConn.class);
+
+  /** The results of reading the channel */
+  static final int CONTINUE = 0;
+  static final int CLOSED = 1;
+  static final int HAND_OFF = 2;
+
+  private static final int READ_COMMAND = 0;
+  private static final int READ_OP = 1;
+  private static final int READ_HEAD = 2;
+  private static final int READ_BODY = 3;
+
+  private final SocketChannel channel;
+  private final int selfID;
+  private final EventQueue eventQueue;
+  private final DataMap dataMap;
+
+  private int state;
+  private byte commandType;
+  private final byte[] opBytes;
+  private ByteArray headArray;
+  private Data data;
+  /** The array being filled */
+  private byte[] target;
+  private int targetPos;
+  private int targetRemaining;
+  /** Bytes read ahead before a hand-off */
+  private byte[] leftover;
+
+  NioConn(SocketChannel channel, int selfID,
+    EventQueue queue, DataMap map) {
+    this.channel = channel;
+    this.selfID = selfID;
+    this.eventQueue = queue;
+    this.dataMap = map;
+    this.state = READ_COMMAND;
+    this.commandType = Constant.UNKNOWN_CMD;
+    this.opBytes = new byte[4];
+    this.headArray = null;
+    this.data = null;
+    this.leftover = null;
+  }
+
+  /**
+   * Get the channel
+   *
+   * @return the channel
+   */
+  SocketChannel getChannel() {
+    return channel;
+  }
+
+  /**
+   * Get the command which caused the hand-off
+   *
+   * @return the command type
+   */
+  byte getCommandType() {
+    return commandType;
+  }
+
+  /**
+   * Read the available bytes from the channel
+   * through the buffer of the event loop and
+   * advance the parsing.
+   *
+   * @param buffer
+   *          the direct buffer of the event loop
+   * @return CONTINUE, CLOSED or HAND_OFF
+   * @throws Exception
+   */
+  int read(ByteBuffer buffer) throws Exception {
+    buffer.clear();
+    int len = channel.read(buffer);
+    if (len < 0) {
+      return CLOSED;
+    }
+    buffer.flip();
+    while (buffer.hasRemaining()) {
+      if (state == READ_COMMAND) {
+        commandType = buffer.get();
+        if (commandType == Constant.SEND
+          || commandType == Constant.SEND_DECODE) {
+          setTarget(opBytes, 0, opBytes.length);
+          state = READ_OP;
+        } else if (commandType == Constant.CHAIN_BCAST
+          || commandType == Constant.CHAIN_BCAST_DECODE
+          || commandType == Constant.MST_BCAST
+          || commandType == Constant.MST_BCAST_DECODE) {
+          leftover = new byte[buffer.remaining()];
+          buffer.get(leftover);
+          return HAND_OFF;
+        } else {
+          // CONNECTION_END, SERVER_QUIT or unknown
+          if (commandType != Constant.CONNECTION_END
+            && commandType != Constant.SERVER_QUIT) {
+            LOG.info(
+              "Unknown command: " + commandType);
+          }
+          return CLOSED;
+        }
+      } else {
+        int size = Math.min(targetRemaining,
+          buffer.remaining());
+        buffer.get(target, targetPos, size);
+        targetPos += size;
+        targetRemaining -= size;
+        if (targetRemaining == 0) {
+          onTargetFilled();
+        }
+      }
+    }
+    return CONTINUE;
+  }
+
+  /**
+   * Move to the next state when the current
+   * array is filled
+   *
+   * @throws Exception
+   */
+  private void onTargetFilled() throws Exception {
+    if (state == READ_OP) {
+      int headArrSize = ((opBytes[0] & 0xff) << 24)
+        | ((opBytes[1] & 0xff) << 16)
+        | ((opBytes[2] & 0xff) << 8)
+        | (opBytes[3] & 0xff);
+      headArray =
+        ByteArray.create(headArrSize, true);
+      if (headArray == null) {
+        throw new Exception("Null head array");
+      }
+      state = READ_HEAD;
+      setTarget(headArray.get(), headArray.start(),
+        headArrSize);
+      if (headArrSize == 0) {
+        onTargetFilled();
+      }
+    } else if (state == READ_HEAD) {
+      data = new Data(headArray);
+      headArray = null;
+      data.decodeHeadArray();
+      ByteArray bodyArray = data.getBodyArray();
+      if (bodyArray != null
+        && bodyArray.size() > 0) {
+        state = READ_BODY;
+        setTarget(bodyArray.get(),
+          bodyArray.start(), bodyArray.size());
+      } else {
+        deliver();
+      }
+    } else if (state == READ_BODY) {
+      deliver();
+    }
+  }
+
+  /**
+   * Pass the received data to the DataMap or the
+   * EventQueue, the same as DataReceiver
+   */
+  private void deliver() {
+    Data recvData = data;
+    data = null;
+    state = READ_COMMAND;
+    setTarget(null, 0, 0);
+    if (commandType == Constant.SEND_DECODE) {
+      (new Decoder(recvData, selfID,
+        EventType.MESSAGE_EVENT, eventQueue,
+        dataMap)).fork();
+    } else {
+      DataUtil.addDataToQueueOrMap(selfID,
+        eventQueue, EventType.MESSAGE_EVENT,
+        dataMap, recvData);
+    }
+  }
+
+  private void setTarget(byte[] bytes, int start,
+    int size) {
+    target = bytes;
+    targetPos = start;
+    targetRemaining = size;
+  }
+
+  /**
+   * Create the ServerConn for a blocking
+   * Acceptor. The channel must be deregistered
+   * from the selector.
+   *
+   * @return the ServerConn
+   * @throws IOException
+   */
+  ServerConn handOff() throws IOException {
+    channel.configureBlocking(true);
+    Socket socket = channel.socket();
+    InputStream in = socket.getInputStream();
+    if (leftover != null && leftover.length > 0) {
+      in = new SequenceInputStream(
+        new ByteArrayInputStream(leftover), in);
+    }
+    leftover = null;
+    return new ServerConn(in, socket);
+  }
+
+  /**
+   * Close the connection and release the arrays
+   * of a partially received data
+   */
+  void close() {
+    if (headArray != null) {
+      headArray.release();
+      headArray = null;
+    }
+    if (data != null) {
+      data.release();
+      data = null;
+    }
+    try {
+      channel.close();
+    } catch (IOException e) {
+    }
+  }
+}
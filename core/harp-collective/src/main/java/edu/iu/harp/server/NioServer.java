@@ -0,0 +1,349 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.harp.server;
+
+import edu.iu.harp.io.Constant;
+import edu.iu.harp.io.DataMap;
+import edu.iu.harp.io.EventQueue;
+import edu.iu.harp.io.IOUtil;
+import edu.iu.harp.schdynamic.ComputeUtil;
+import edu.iu.harp.worker.Workers;
+import it.unimi.dsi.fastutil.objects.ObjectArrayList;
+import org.apache.log4j.Logger;
+
+import java.io.IOException;
+import java.net.InetSocketAddress;
+import java.nio.ByteBuffer;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.SelectionKey;
+import java.nio.channels.Selector;
+import java.nio.channels.ServerSocketChannel;
+import java.nio.channels.SocketChannel;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Queue;
+import java.util.concurrent.ConcurrentLinkedQueue;
+
+/*******************************************************
+ * The server of the NIO transport. Accepted
+ * connections are spread over a few event loops.
+ * Each event loop reads with one direct buffer
+ * and parses point-to-point data without a
+ * thread per connection. Broadcast connections
+ * are handed off to blocking Acceptor threads.
+ ******************************************************/
+public class NioServer implements Runnable {
+
+  private static final Logger LOG =
+    Logger.getLogger(NioServer.class);
+
+  private final EventQueue eventQueue;
+  private final DataMap dataMap;
+  private final Workers workers;
+  private final int selfID;
+  private final String node;
+  private final int port;
+  private final ServerSocketChannel serverChannel;
+  private final Thread server;
+  private final EventLoop[] eventLoops;
+  private final Thread[] eventLoopThreads;
+  private final List<Thread> acceptors;
+  /** Guards numConns, notified when it is 0 */
+  private final Object connLock;
+  /** The number of the open connections */
+  private int numConns;
+  private volatile boolean isRunning;
+
+  /**
+   * Initialization
+   *
+   * @param node
+   *          the host
+   * @param port
+   *          the port
+   * @param queue
+   *          the EventQueue
+   * @param map
+   *          the DataMap
+   * @param workers
+   *          the Workers
+   * @throws Exception
+   */
+  public NioServer(String node, int port,
+    EventQueue queue, DataMap map,
+    Workers workers) throws Exception {
+    this.eventQueue = queue;
+    this.dataMap = map;
+    this.workers = workers;
+    this.selfID = workers.getSelfID();
+    this.node = node;
+    this.port = port;
+    this.server = new Thread(this);
+    this.acceptors = new ObjectArrayList<>();
+    this.connLock = new Object();
+    this.numConns = 0;
+    int numEventLoops = Math.max(1, Math.min(
+      Constant.NUM_NIO_EVENT_LOOPS,
+      Constant.NUM_THREADS));
+    this.eventLoops = new EventLoop[numEventLoops];
+    this.eventLoopThreads =
+      new Thread[numEventLoops];
+    try {
+      for (int i = 0; i < numEventLoops; i++) {
+        eventLoops[i] = new EventLoop();
+        eventLoopThreads[i] =
+          new Thread(eventLoops[i]);
+      }
+      serverChannel = ServerSocketChannel.open();
+      IOUtil
+        .setServerSocketOptions(serverChannel.socket());
+      serverChannel
+        .bind(new InetSocketAddress(node, port));
+    } catch (Exception e) {
+      LOG.error("Error in starting receiver.", e);
+      throw new Exception(e);
+    }
+    LOG.info("NIO server on " + this.node + " "
+      + this.port + " with " + numEventLoops
+      + " event loops starts.");
+  }
+
+  /**
+   * Start the server
+   */
+  public void start() {
+    isRunning = true;
+    for (Thread thread : eventLoopThreads) {
+      thread.start();
+    }
+    server.start();
+  }
+
+  /**
+   * Stop the server. Wait for the clients to
+   * close their connections, then close the
+   * event loops and the server channel.
+   */
+  public void stop() {
+    long deadline = System.currentTimeMillis()
+      + Constant.TERMINATION_TIMEOUT * 1000L;
+    synchronized (connLock) {
+      long timeout = deadline
+        - System.currentTimeMillis();
+      while (numConns > 0 && timeout > 0L) {
+        try {
+          connLock.wait(timeout);
+        } catch (InterruptedException e) {
+          Thread.currentThread().interrupt();
+          break;
+        }
+        timeout = deadline
+          - System.currentTimeMillis();
+      }
+      if (numConns > 0) {
+        LOG.info("Close " + numConns
+          + " open connections.");
+      }
+    }
+    synchronized (acceptors) {
+      for (Thread thread : acceptors) {
+        ComputeUtil.joinThread(thread);
+      }
+    }
+    isRunning = false;
+    try {
+      serverChannel.close();
+    } catch (IOException e) {
+      LOG.error("Fail to stop the server.", e);
+    }
+    ComputeUtil.joinThread(server);
+    for (int i = 0; i < eventLoops.length; i++) {
+      eventLoops[i].selector.wakeup();
+      ComputeUtil.joinThread(eventLoopThreads[i]);
+    }
+    LOG.info("NIO server on " + this.node + " "
+      + this.port + " is stopped.");
+  }
+
+  /**
+   * Accept the connections and assign them to
+   * the event loops round-robin
+   */
+  @Override
+  public void run() {
+    int next = 0;
+    while (isRunning) {
+      SocketChannel channel = null;
+      try {
+        channel = serverChannel.accept();
+        IOUtil.setSocketOptions(channel.socket());
+        channel.configureBlocking(false);
+      } catch (ClosedChannelException e) {
+        break;
+      } catch (Exception e) {
+        LOG.error("Exception on NIO server", e);
+        if (channel != null) {
+          try {
+            channel.close();
+          } catch (IOException e1) {
+          }
+        }
+        continue;
+      }
+      synchronized (connLock) {
+        numConns++;
+      }
+      eventLoops[next].register(channel);
+      next = (next + 1) % eventLoops.length;
+    }
+  }
+
+  /**
+   * Run a blocking Acceptor for a broadcast
+   * connection
+   *
+   * @param conn
+   *          the connection deregistered from its
+   *          event loop
+   */
+  private void handOff(NioConn conn) {
+    ServerConn serverConn = null;
+    try {
+      serverConn = conn.handOff();
+    } catch (IOException e) {
+      LOG.error("Fail to hand off connection", e);
+      closeConn(conn);
+      return;
+    }
+    final Acceptor acceptor =
+      new Acceptor(serverConn, eventQueue, dataMap,
+        workers, conn.getCommandType());
+    Thread thread = new Thread(() -> {
+      try {
+        acceptor.run();
+      } finally {
+        removeConn();
+      }
+    });
+    synchronized (acceptors) {
+      acceptors.add(thread);
+    }
+    thread.start();
+  }
+
+  private void closeConn(NioConn conn) {
+    conn.close();
+    removeConn();
+  }
+
+  private void removeConn() {
+    synchronized (connLock) {
+      numConns--;
+      if (numConns == 0) {
+        connLock.notifyAll();
+      }
+    }
+  }
+
+  /*******************************************************
+   * An event loop serving a set of connections
+   * with one selector and one direct buffer
+   ******************************************************/
+  private class EventLoop implements Runnable {
+    private final Selector selector;
+    private final ByteBuffer buffer;
+    private final Queue<SocketChannel> newChannels;
+
+    private EventLoop() throws IOException {
+      selector = Selector.open();
+      buffer =
+        ByteBuffer.allocateDirect(Constant.BUFFER_SIZE);
+      newChannels = new ConcurrentLinkedQueue<>();
+    }
+
+    private void register(SocketChannel channel) {
+      newChannels.add(channel);
+      selector.wakeup();
+    }
+
+    @Override
+    public void run() {
+      List<NioConn> handOffs =
+        new ObjectArrayList<>();
+      while (isRunning) {
+        try {
+          selector.select();
+        } catch (IOException e) {
+          LOG.error("Exception on event loop", e);
+          continue;
+        }
+        SocketChannel channel = null;
+        while ((channel = newChannels.poll()) != null) {
+          try {
+            channel.register(selector,
+              SelectionKey.OP_READ, new NioConn(
+                channel, selfID, eventQueue,
+                dataMap));
+          } catch (ClosedChannelException e) {
+            removeConn();
+          }
+        }
+        Iterator<SelectionKey> iterator =
+          selector.selectedKeys().iterator();
+        while (iterator.hasNext()) {
+          SelectionKey key = iterator.next();
+          iterator.remove();
+          NioConn conn = (NioConn) key.attachment();
+          int status = NioConn.CLOSED;
+          try {
+            status = conn.read(buffer);
+          } catch (Exception e) {
+            LOG.error("Exception in handling data",
+              e);
+          }
+          if (status == NioConn.CLOSED) {
+            key.cancel();
+            closeConn(conn);
+          } else if (status == NioConn.HAND_OFF) {
+            key.cancel();
+            handOffs.add(conn);
+          }
+        }
+        if (!handOffs.isEmpty()) {
+          // Flush the cancelled keys so that the
+          // channels can be set to blocking
+          try {
+            selector.selectNow();
+          } catch (IOException e) {
+            LOG.error("Exception on event loop", e);
+          }
+          for (NioConn conn : handOffs) {
+            handOff(conn);
+          }
+          handOffs.clear();
+        }
+      }
+      for (SelectionKey key : selector.keys()) {
+        closeConn((NioConn) key.attachment());
+      }
+      try {
+        selector.close();
+      } catch (IOException e) {
+      }
+    }
+  }
+}
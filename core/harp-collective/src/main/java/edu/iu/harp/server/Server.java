@@ -21,6 +21,7 @@ import edu.iu.harp.io.Constant;
 import edu.iu.harp.io.DataMap;
 import edu.iu.harp.io.EventQueue;
 import edu.iu.harp.io.IOUtil;
+import edu.iu.harp.io.Transport;
 import edu.iu.harp.schdynamic.ComputeUtil;
 import edu.iu.harp.worker.Workers;
 import it.unimi.dsi.fastutil.objects.ObjectArrayList;
@@ -62,6 +63,8 @@ public class Server implements Runnable {
   private final int port;
   /** Server socket */
   private final ServerSocket serverSocket;
+  /** Used instead with the NIO transport */
+  private final NioServer nioServer;
 
   /**
    * Initialization
@@ -89,6 +92,13 @@ public class Server implements Runnable {
     // Cache local information
     this.node = node;
     this.port = port;
+    if (Transport.get() == Transport.NIO) {
+      nioServer = new NioServer(node, port, queue,
+        map, workers);
+      serverSocket = null;
+      return;
+    }
+    nioServer = null;
     // Server socket
     try {
       serverSocket = new ServerSocket();
@@ -107,6 +117,10 @@ public class Server implements Runnable {
    * Start the server
    */
   public void start() {
+    if (nioServer != null) {
+      nioServer.start();
+      return;
+    }
     server.start();
   }
 
@@ -115,6 +129,10 @@ public class Server implements Runnable {
    * server
    */
   public void stop() {
+    if (nioServer != null) {
+      nioServer.stop();
+      return;
+    }
     for (Thread thread : acceptors) {
       ComputeUtil.joinThread(thread);
     }
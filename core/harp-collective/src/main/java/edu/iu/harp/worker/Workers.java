@@ -19,7 +19,9 @@ package edu.iu.harp.worker;
 import edu.iu.harp.io.Constant;
 
 import java.io.BufferedReader;
+import java.util.Collections;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
 import java.util.LinkedList;
 import java.util.List;
 import java.util.Map;
@@ -68,6 +70,15 @@ public class Workers extends Nodes {
    * Worker ID of the next worker
    */
   private final int nextID;
+  /**
+   * Map from node to the IDs of the workers on
+   * it, ordered by the smallest worker ID
+   */
+  private final Map<String, List<Integer>> nodeWorkers;
+  /**
+   * The node leaders, created on demand
+   */
+  private Workers nodeLeaders;
   private final int initCapacity =
       Constant.NUM_THREADS;
 
@@ -96,6 +107,57 @@ public class Workers extends Nodes {
 
     this.masterInfo = workerInfos.get(masterID);
     this.minID = minID;
+    this.nodeWorkers = groupWorkersByNode(
+        workerInfos, minID, maxID);
+  }
+
+  /**
+   * A view of a subset of the workers, renumbered
+   * from 0 in the order of the given WorkerInfos.
+   * The hosts and ports are kept, so data can be
+   * sent to the members through this view.
+   *
+   * @param nodes       the nodes
+   * @param memberInfos the WorkerInfos of the members
+   * @param selfid      this worker's ID in the view,
+   *                    or unknown if not a member
+   */
+  private Workers(Nodes nodes,
+                  List<WorkerInfo> memberInfos, int selfid) {
+    super(nodes.getNodes(),
+        new LinkedList<>(nodes.getRackList()),
+        nodes.getNumPhysicalNodes());
+    workerInfos =
+        new ConcurrentHashMap<>(initCapacity);
+    rackWorkers =
+        new ConcurrentHashMap<>(initCapacity);
+    int workerID = -1;
+    for (WorkerInfo info : memberInfos) {
+      workerID++;
+      workerInfos.put(workerID,
+          new WorkerInfo(workerID, info.getNode(),
+              info.getPort(), info.getRack()));
+      List<Integer> workerIDs =
+          rackWorkers.get(info.getRack());
+      if (workerIDs == null) {
+        workerIDs = new LinkedList<>();
+        rackWorkers.put(info.getRack(), workerIDs);
+      }
+      workerIDs.add(workerID);
+    }
+    selfID = selfid;
+    masterID = 0;
+    masterInfo = workerInfos.get(masterID);
+    minID = 0;
+    maxID = workerID;
+    middleID = workerID / 2;
+    if (selfID >= 0 && selfID < maxID) {
+      nextID = selfID + 1;
+    } else {
+      nextID = 0;
+    }
+    nodeWorkers =
+        groupWorkersByNode(workerInfos, minID, maxID);
   }
 
   /**
@@ -145,6 +207,39 @@ public class Workers extends Nodes {
     } else {
       nextID = 0;
     }
+    nodeWorkers =
+        groupWorkersByNode(workerInfos, minID, maxID);
+  }
+
+  /**
+   * Group the worker IDs by the node they run on
+   *
+   * @param infos the map from worker ID to worker
+   *              info
+   * @param min   the minimum worker ID
+   * @param max   the maximum worker ID
+   * @return the map from node to worker IDs
+   */
+  private static Map<String, List<Integer>>
+  groupWorkersByNode(Map<Integer, WorkerInfo> infos,
+                     int min, int max) {
+    Map<String, List<Integer>> workersByNode =
+        new LinkedHashMap<>();
+    for (int i = min; i <= max; i++) {
+      WorkerInfo info = infos.get(i);
+      if (info == null) {
+        continue;
+      }
+      List<Integer> workerIDs =
+          workersByNode.get(info.getNode());
+      if (workerIDs == null) {
+        workerIDs = new LinkedList<>();
+        workersByNode.put(info.getNode(),
+            workerIDs);
+      }
+      workerIDs.add(i);
+    }
+    return workersByNode;
   }
 
   /**
@@ -291,6 +386,147 @@ public class Workers extends Nodes {
     return workerInfos.get(workerID);
   }
 
+  /**
+   * Get the number of the nodes which run the
+   * workers
+   *
+   * @return the number of the nodes
+   */
+  public int getNumNodes() {
+    return nodeWorkers.size();
+  }
+
+  /**
+   * Get the IDs of the workers on the node of the
+   * given worker, including itself
+   *
+   * @param workerID the worker
+   * @return the IDs of the co-located workers
+   */
+  public List<Integer> getLocalWorkerIDs(
+      int workerID) {
+    WorkerInfo info = workerInfos.get(workerID);
+    if (info == null) {
+      return Collections.emptyList();
+    }
+    return Collections.unmodifiableList(
+        nodeWorkers.get(info.getNode()));
+  }
+
+  /**
+   * Get the IDs of the workers on the node of
+   * this worker, including this worker
+   *
+   * @return the IDs of the co-located workers
+   */
+  public List<Integer> getLocalWorkerIDs() {
+    return getLocalWorkerIDs(selfID);
+  }
+
+  /**
+   * Check if the worker runs on the same node as
+   * this worker
+   *
+   * @param workerID the worker
+   * @return true if co-located, false otherwise
+   */
+  public boolean isLocalWorker(int workerID) {
+    WorkerInfo selfInfo = getSelfInfo();
+    WorkerInfo info = workerInfos.get(workerID);
+    return selfInfo != null && info != null
+        && selfInfo.getNode().equals(info.getNode());
+  }
+
+  /**
+   * Get the node leader of the given worker. The
+   * leader is the worker with the smallest ID on
+   * the node.
+   *
+   * @param workerID the worker
+   * @return the ID of the node leader
+   */
+  public int getNodeLeaderID(int workerID) {
+    List<Integer> localIDs =
+        getLocalWorkerIDs(workerID);
+    if (localIDs.isEmpty()) {
+      return Constant.UNKNOWN_WORKER_ID;
+    }
+    return localIDs.get(0);
+  }
+
+  /**
+   * Get the node leader of this worker
+   *
+   * @return the ID of the node leader
+   */
+  public int getNodeLeaderID() {
+    return getNodeLeaderID(selfID);
+  }
+
+  /**
+   * Check if this worker is the leader of its
+   * node
+   *
+   * @return true if yes, false otherwise
+   */
+  public boolean isNodeLeader() {
+    return isSelfInWorker()
+        && getNodeLeaderID() == selfID;
+  }
+
+  /**
+   * Get the node ID of the given worker. Nodes
+   * are numbered from 0 by their smallest worker
+   * ID, the same as the worker IDs in the node
+   * leader view.
+   *
+   * @param workerID the worker
+   * @return the node ID, or unknown
+   */
+  public int getNodeID(int workerID) {
+    WorkerInfo info = workerInfos.get(workerID);
+    if (info == null) {
+      return Constant.UNKNOWN_WORKER_ID;
+    }
+    int nodeID = 0;
+    for (String node : nodeWorkers.keySet()) {
+      if (node.equals(info.getNode())) {
+        return nodeID;
+      }
+      nodeID++;
+    }
+    return Constant.UNKNOWN_WORKER_ID;
+  }
+
+  /**
+   * Get the view of the node leaders, one worker
+   * per node. The leaders are renumbered by their
+   * node IDs. Collective operations on this view
+   * send data across the nodes only. The workers
+   * on a node exchange data with their leader
+   * through shared segments, see LocalExchange.
+   *
+   * @return the node leaders
+   */
+  public synchronized Workers getNodeLeaders() {
+    if (nodeLeaders == null) {
+      List<WorkerInfo> leaderInfos =
+          new LinkedList<>();
+      for (List<Integer> workerIDs : nodeWorkers
+          .values()) {
+        leaderInfos
+            .add(workerInfos.get(workerIDs.get(0)));
+      }
+      int selfNodeID = Constant.UNKNOWN_WORKER_ID;
+      if (isNodeLeader()) {
+        selfNodeID = getNodeID(selfID);
+      }
+      nodeLeaders =
+          new Workers(this, leaderInfos, selfNodeID);
+    }
+    return nodeLeaders;
+  }
+
   /**
    * Get the iterable class of the WorkerInfos
    *
@@ -0,0 +1,38 @@
+package edu.iu.harp.collective;
+
+import org.junit.Assert;
+import org.junit.Test;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+
+public class CollectiveRequestTest {
+  @Test
+  public void testCollectiveRequest() throws Exception {
+    ExecutorService executor = Executors.newCachedThreadPool();
+    CountDownLatch latch = new CountDownLatch(1);
+    CollectiveRequest request = CollectiveRequest.start("test", "op-1",
+        () -> {
+          try {
+            latch.await();
+          } catch (InterruptedException e) {
+            return false;
+          }
+          return true;
+        }, executor);
+    CollectiveRequest failed = CollectiveRequest.start("test", "op-2",
+        () -> false, executor);
+
+    Assert.assertEquals("test", request.getContextName());
+    Assert.assertEquals("op-1", request.getOperationName());
+    Assert.assertFalse(request.test());
+    Assert.assertFalse(failed.waitFor());
+
+    latch.countDown();
+    Assert.assertTrue(request.waitFor());
+    Assert.assertTrue(request.test());
+    Assert.assertFalse(CollectiveRequest.waitForAll(request, failed));
+    executor.shutdown();
+  }
+}
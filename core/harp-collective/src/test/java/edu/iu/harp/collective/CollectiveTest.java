@@ -0,0 +1,236 @@
+package edu.iu.harp.collective;
+
+import edu.iu.harp.example.DoubleArrPlus;
+import edu.iu.harp.io.ConnPool;
+import edu.iu.harp.io.Constant;
+import edu.iu.harp.io.DataMap;
+import edu.iu.harp.io.EventQueue;
+import edu.iu.harp.io.SharedSegment;
+import edu.iu.harp.partition.Partition;
+import edu.iu.harp.partition.Table;
+import edu.iu.harp.resource.DoubleArray;
+import edu.iu.harp.server.Server;
+import edu.iu.harp.worker.Workers;
+import org.junit.After;
+import org.junit.Assert;
+import org.junit.Before;
+import org.junit.Test;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.StringReader;
+import java.nio.file.Files;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Runs four workers in this JVM, two on "127.0.0.1" and two on "localhost",
+ * so that they are grouped into two nodes.
+ */
+public class CollectiveTest {
+
+  private static final String NODES =
+      "#0\n127.0.0.1\n127.0.0.1\nlocalhost\nlocalhost\n";
+  private static final int NUM_WORKERS = 4;
+  private static final int ARRAY_SIZE = 10;
+
+  private interface WorkerTask {
+    boolean run(Table<DoubleArray> table, DataMap dataMap,
+        Workers workers);
+  }
+
+  private List<Workers> workersList;
+  private List<DataMap> dataMaps;
+  private List<Server> servers;
+  private File segmentDir;
+  private File oldSegmentDir;
+
+  @Before
+  public void setUp() throws Exception {
+    segmentDir = Files.createTempDirectory("harp-segment").toFile();
+    oldSegmentDir = SharedSegment.getDir();
+    SharedSegment.setDir(segmentDir);
+    workersList = new ArrayList<>();
+    dataMaps = new ArrayList<>();
+    servers = new ArrayList<>();
+    for (int i = 0; i < NUM_WORKERS; i++) {
+      Workers workers = new Workers(
+          new BufferedReader(new StringReader(NODES)), i);
+      DataMap dataMap = new DataMap();
+      Server server = new Server(workers.getSelfInfo().getNode(),
+          workers.getSelfInfo().getPort(), new EventQueue(), dataMap,
+          workers);
+      server.start();
+      workersList.add(workers);
+      dataMaps.add(dataMap);
+      servers.add(server);
+    }
+  }
+
+  @After
+  public void tearDown() {
+    ConnPool.get().clean();
+    for (Server server : servers) {
+      server.stop();
+    }
+    SharedSegment.setEnabled(true);
+    SharedSegment.setDir(oldSegmentDir);
+    for (File file : segmentDir.listFiles()) {
+      file.delete();
+    }
+    segmentDir.delete();
+  }
+
+  @Test
+  public void testNodeGroups() {
+    Workers workers = workersList.get(3);
+    Assert.assertEquals(2, workers.getNumNodes());
+    Assert.assertEquals(2, workers.getNodeLeaderID());
+    Assert.assertEquals(1, workers.getNodeID(3));
+    Assert.assertEquals(2, workers.getNodeLeaders().getNumWorkers());
+  }
+
+  @Test
+  public void testTreeBroadcast() throws Exception {
+    runBroadcast(1, (table, dataMap, workers) -> BcastCollective
+        .treeBroadcast("test", "tree-bcast", table, 1, dataMap, workers));
+  }
+
+  @Test
+  public void testHierarchicalBroadcast() throws Exception {
+    // The broadcasting worker is not a node leader
+    runBroadcast(3, (table, dataMap, workers) -> BcastCollective
+        .hierarchicalBroadcast("test", "hier-bcast", table, 3, dataMap,
+            workers));
+    Assert.assertEquals(0, segmentDir.list().length);
+  }
+
+  @Test
+  public void testHierarchicalAllreduce() throws Exception {
+    runHierarchicalAllreduce("hier-allreduce");
+    Assert.assertEquals(0, segmentDir.list().length);
+  }
+
+  @Test
+  public void testHierarchicalAllreduceWithoutSegments() throws Exception {
+    SharedSegment.setEnabled(false);
+    runHierarchicalAllreduce("hier-allreduce-tcp");
+  }
+
+  @Test
+  public void testRingAllreduce() throws Exception {
+    // 2 MB partitions, 3 per chunk, so each chunk is sent in two segments
+    // and the last one carries the segment count. Negative IDs go to
+    // the chunks by floorMod. Chunk 1 starts on worker 1, which has no
+    // partition 5, so worker 2 adds its own partition 5 when forwarding.
+    // Worker 1 gets partition 5 back in the allgather steps.
+    int arraySize = Constant.RING_SEGMENT_SIZE / 16;
+    List<Table<DoubleArray>> tables = new ArrayList<>();
+    for (int i = 0; i < NUM_WORKERS; i++) {
+      Table<DoubleArray> table = new Table<>(0, new DoubleArrPlus());
+      for (int p = -4; p < 8; p++) {
+        if (i != 1 || p != 5) {
+          table.addPartition(
+              new Partition<>(p, createArray(arraySize, i + p)));
+        }
+      }
+      tables.add(table);
+    }
+    runWorkers(tables, (table, dataMap, workers) -> AllreduceCollective
+        .ringAllreduce("test", "ring-allreduce", table, dataMap, workers));
+    for (Table<DoubleArray> table : tables) {
+      Assert.assertEquals(12, table.getNumPartitions());
+      for (int p = -4; p < 8; p++) {
+        double expected = p == 5 ? 5 + 3 * p : 6 + NUM_WORKERS * p;
+        double[] values = table.getPartition(p).get().get();
+        Assert.assertEquals(arraySize, table.getPartition(p).get().size());
+        Assert.assertEquals(expected, values[0], 0.0);
+        Assert.assertEquals(expected, values[arraySize - 1], 0.0);
+      }
+    }
+  }
+
+  private void runBroadcast(int bcastWorkerID, WorkerTask task)
+      throws Exception {
+    List<Table<DoubleArray>> tables = createTables(2);
+    for (int i = 0; i < NUM_WORKERS; i++) {
+      if (i != bcastWorkerID) {
+        tables.get(i).release();
+      }
+    }
+    runWorkers(tables, task);
+    for (Table<DoubleArray> table : tables) {
+      Assert.assertEquals(2, table.getNumPartitions());
+      for (int p = 0; p < 2; p++) {
+        double[] values = table.getPartition(p).get().get();
+        Assert.assertEquals(bcastWorkerID + p, values[0], 0.0);
+        Assert.assertEquals(bcastWorkerID + p, values[ARRAY_SIZE - 1],
+            0.0);
+      }
+    }
+  }
+
+  private void runHierarchicalAllreduce(String operationName)
+      throws Exception {
+    List<Table<DoubleArray>> tables = createTables(3);
+    runWorkers(tables, (table, dataMap, workers) -> AllreduceCollective
+        .hierarchicalAllreduce("test", operationName, table, false,
+            dataMap, workers));
+    // Sum of worker IDs 0..3 plus the partition ID from each worker
+    for (Table<DoubleArray> table : tables) {
+      Assert.assertEquals(3, table.getNumPartitions());
+      for (int p = 0; p < 3; p++) {
+        double[] values = table.getPartition(p).get().get();
+        Assert.assertEquals(6 + NUM_WORKERS * p, values[0], 0.0);
+        Assert.assertEquals(6 + NUM_WORKERS * p, values[ARRAY_SIZE - 1],
+            0.0);
+      }
+    }
+  }
+
+  /**
+   * Each worker gets partitions 0 to numPartitions - 1, all values of
+   * partition p on worker w are w + p.
+   */
+  private List<Table<DoubleArray>> createTables(int numPartitions) {
+    List<Table<DoubleArray>> tables = new ArrayList<>();
+    for (int i = 0; i < NUM_WORKERS; i++) {
+      Table<DoubleArray> table = new Table<>(0, new DoubleArrPlus());
+      for (int p = 0; p < numPartitions; p++) {
+        table.addPartition(
+            new Partition<>(p, createArray(ARRAY_SIZE, i + p)));
+      }
+      tables.add(table);
+    }
+    return tables;
+  }
+
+  private DoubleArray createArray(int size, double value) {
+    DoubleArray array = DoubleArray.create(size, false);
+    Arrays.fill(array.get(), 0, size, value);
+    return array;
+  }
+
+  private void runWorkers(List<Table<DoubleArray>> tables,
+      WorkerTask task) throws Exception {
+    ExecutorService executor = Executors.newFixedThreadPool(NUM_WORKERS);
+    try {
+      List<Future<Boolean>> results = new ArrayList<>();
+      for (int i = 0; i < NUM_WORKERS; i++) {
+        final int workerID = i;
+        results.add(executor.submit(() -> task.run(tables.get(workerID),
+            dataMaps.get(workerID), workersList.get(workerID))));
+      }
+      for (Future<Boolean> result : results) {
+        Assert.assertTrue(result.get(60, TimeUnit.SECONDS));
+      }
+    } finally {
+      executor.shutdownNow();
+    }
+  }
+}
@@ -1,7 +1,10 @@
 package edu.iu.harp.io;
 
+import edu.iu.harp.partition.Partition;
 import edu.iu.harp.resource.IntArray;
 import edu.iu.harp.resource.Transferable;
+import edu.iu.harp.resource.WritableRegistry;
+import edu.iu.harp.util.PartitionCount;
 import org.junit.Assert;
 import org.junit.Test;
 
@@ -137,4 +140,79 @@ public class DataTest {
     Data encodedData = new Data(data.getHeadArray(), data.getBodyArray());
     encodedData.decodeHeadArray();
   }
+
+  @Test
+  public void testWritablePartitionList() {
+    WritableRegistry registry = WritableRegistry.get();
+    try {
+      // Class names, one by one
+      registry.setUseBatch(false);
+      checkWritablePartitionList(5);
+      // Class name once per list
+      registry.setUseBatch(true);
+      checkWritablePartitionList(5);
+      // Too short for a batch
+      checkWritablePartitionList(2);
+      // Class ID once per list
+      registry.register(PartitionCount.class);
+      checkWritablePartitionList(5);
+      checkWritablePartitionList(1);
+    } finally {
+      registry.reset();
+      registry.setUseBatch(true);
+    }
+  }
+
+  @Test
+  public void testWritableBatchSize() {
+    WritableRegistry registry = WritableRegistry.get();
+    try {
+      registry.register(PartitionCount.class);
+      List<Transferable> transList = createPartitionCounts(10);
+      int numBytes = 0;
+      for (Transferable trans : transList) {
+        numBytes += trans.getNumEnocdeBytes();
+      }
+      // Data type, class ID, count, then ID and two ints each
+      int batchBytes = 1 + 2 + 4 + 10 * (4 + 8);
+      Assert.assertEquals(batchBytes,
+          DataUtil.getNumTransListBytes(transList));
+      Assert.assertTrue(batchBytes < numBytes);
+    } finally {
+      registry.reset();
+    }
+  }
+
+  private static List<Transferable> createPartitionCounts(int numPartitions) {
+    List<Transferable> transList = new ArrayList<>(numPartitions);
+    for (int i = 0; i < numPartitions; i++) {
+      PartitionCount count = new PartitionCount();
+      count.setWorkerID(i);
+      count.setPartitionCount(i * 10);
+      transList.add(new Partition<>(i + 100, count));
+    }
+    return transList;
+  }
+
+  private static void checkWritablePartitionList(int numPartitions) {
+    List<Transferable> transList = createPartitionCounts(numPartitions);
+    Data data = new Data(DataType.PARTITION_LIST, "conn", 0,
+        transList, DataUtil.getNumTransListBytes(transList));
+    Assert.assertEquals(DataStatus.ENCODED_ARRAY_DECODED, data.encodeHead());
+    Assert.assertEquals(DataStatus.ENCODED_ARRAY_DECODED, data.encodeBody());
+
+    Data encodedData = new Data(data.getHeadArray(), data.getBodyArray());
+    encodedData.decodeHeadArray();
+    Assert.assertEquals(DataStatus.ENCODED_ARRAY_DECODED,
+        encodedData.decodeBodyArray());
+    List<Transferable> partitions = encodedData.getBody();
+    Assert.assertEquals(numPartitions, partitions.size());
+    for (int i = 0; i < numPartitions; i++) {
+      Partition<PartitionCount> partition =
+          (Partition<PartitionCount>) partitions.get(i);
+      Assert.assertEquals(i + 100, partition.id());
+      Assert.assertEquals(i, partition.get().getWorkerID());
+      Assert.assertEquals(i * 10, partition.get().getPartitionCount());
+    }
+  }
 }
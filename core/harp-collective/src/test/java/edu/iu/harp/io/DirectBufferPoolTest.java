@@ -0,0 +1,42 @@
+package edu.iu.harp.io;
+
+import org.junit.Assert;
+import org.junit.Test;
+
+import java.nio.ByteBuffer;
+
+public class DirectBufferPoolTest {
+  @Test
+  public void testAcquire() {
+    DirectBufferPool pool = new DirectBufferPool(64, 1);
+    ByteBuffer buffer = pool.acquire();
+
+    Assert.assertTrue(buffer.isDirect());
+    Assert.assertEquals(64, buffer.capacity());
+    Assert.assertEquals(0, buffer.position());
+  }
+
+  @Test
+  public void testRelease() {
+    DirectBufferPool pool = new DirectBufferPool(64, 1);
+    ByteBuffer buffer = pool.acquire();
+    buffer.putInt(1);
+    pool.release(buffer);
+
+    ByteBuffer newBuffer = pool.acquire();
+    Assert.assertSame(buffer, newBuffer);
+    Assert.assertEquals(0, newBuffer.position());
+    Assert.assertEquals(64, newBuffer.limit());
+  }
+
+  @Test
+  public void testMaxNumFreeBuffers() {
+    DirectBufferPool pool = new DirectBufferPool(64, 1);
+    ByteBuffer buffer1 = pool.acquire();
+    ByteBuffer buffer2 = pool.acquire();
+    pool.release(buffer1);
+    pool.release(buffer2);
+
+    Assert.assertEquals(1, pool.getNumFreeBuffers());
+  }
+}
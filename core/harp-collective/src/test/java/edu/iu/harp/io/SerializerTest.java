@@ -1,5 +1,8 @@
 package edu.iu.harp.io;
 
+import edu.iu.harp.resource.Writable;
+import edu.iu.harp.resource.WritableRegistry;
+import edu.iu.harp.util.PartitionCount;
 import org.junit.Assert;
 import org.junit.Test;
 
@@ -112,4 +115,77 @@ public class SerializerTest {
       Assert.fail();
     }
   }
+
+  @Test
+  public void testSerializeWritable() {
+    byte[] bytes = new byte[256];
+    PartitionCount count = new PartitionCount();
+    count.setWorkerID(3);
+    count.setPartitionCount(7);
+    Serializer serializer = new Serializer(bytes, 0, 256);
+    try {
+      count.encode(serializer);
+    } catch (IOException e) {
+      Assert.fail();
+    }
+    // The class name is an estimate
+    Assert.assertTrue(serializer.getPos() <= count.getNumEnocdeBytes());
+
+    Deserializer deserializer = new Deserializer(bytes, 0, 256);
+    try {
+      Assert.assertEquals(DataType.WRITABLE, deserializer.readByte());
+    } catch (IOException e) {
+      Assert.fail();
+    }
+    Writable obj = DataUtil.deserializeWritable(deserializer);
+    Assert.assertTrue(obj instanceof PartitionCount);
+    Assert.assertEquals(3, ((PartitionCount) obj).getWorkerID());
+    Assert.assertEquals(7, ((PartitionCount) obj).getPartitionCount());
+    Assert.assertEquals(serializer.getPos(), deserializer.getPos());
+  }
+
+  @Test
+  public void testSerializeRegisteredWritable() {
+    WritableRegistry registry = WritableRegistry.get();
+    try {
+      int classID = registry.register(PartitionCount.class);
+      Assert.assertEquals(classID, registry.getClassID(PartitionCount.class));
+      Assert.assertEquals(classID, registry.register(PartitionCount.class));
+
+      byte[] bytes = new byte[64];
+      PartitionCount count = new PartitionCount();
+      count.setWorkerID(1);
+      count.setPartitionCount(2);
+      // Data type, class ID and two ints
+      Assert.assertEquals(1 + 2 + 8, count.getNumEnocdeBytes());
+      Serializer serializer = new Serializer(bytes, 0, 64);
+      try {
+        count.encode(serializer);
+      } catch (IOException e) {
+        Assert.fail();
+      }
+      Assert.assertEquals(count.getNumEnocdeBytes(), serializer.getPos());
+
+      Deserializer deserializer = new Deserializer(bytes, 1, 63);
+      Writable obj = DataUtil.deserializeWritable(deserializer);
+      Assert.assertTrue(obj instanceof PartitionCount);
+      Assert.assertEquals(1, ((PartitionCount) obj).getWorkerID());
+      Assert.assertEquals(2, ((PartitionCount) obj).getPartitionCount());
+    } finally {
+      registry.reset();
+    }
+  }
+
+  @Test
+  public void testDeserializeUnknownClassID() {
+    byte[] bytes = new byte[64];
+    Serializer serializer = new Serializer(bytes, 0, 64);
+    try {
+      serializer.writeShort(100);
+    } catch (IOException e) {
+      Assert.fail();
+    }
+    Deserializer deserializer = new Deserializer(bytes, 0, 64);
+    Assert.assertNull(DataUtil.deserializeWritable(deserializer));
+  }
 }
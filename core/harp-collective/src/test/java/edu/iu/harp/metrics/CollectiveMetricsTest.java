@@ -0,0 +1,106 @@
+package edu.iu.harp.metrics;
+
+import edu.iu.harp.io.Constant;
+
+import org.junit.After;
+import org.junit.Assert;
+import org.junit.Before;
+import org.junit.Test;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.util.List;
+import java.util.Map;
+
+public class CollectiveMetricsTest {
+
+  @Before
+  public void setUp() {
+    CollectiveMetrics.get().reset();
+  }
+
+  @After
+  public void tearDown() {
+    CollectiveMetrics.get().setTracing(false);
+    CollectiveMetrics.get().reset();
+  }
+
+  @Test
+  public void testGetKey() {
+    Assert.assertEquals("main/allgather",
+        CollectiveMetrics.getKey("main", "allgather-3"));
+    Assert.assertEquals("main/regroup",
+        CollectiveMetrics.getKey("main", "regroup_12"));
+    Assert.assertEquals("main/123",
+        CollectiveMetrics.getKey("main", "123"));
+    Assert.assertEquals("main",
+        CollectiveMetrics.getKey("main", null));
+  }
+
+  @Test
+  public void testRecord() {
+    CollectiveMetrics metrics = CollectiveMetrics.get();
+    metrics.record("main", "allgather-0", CollectiveMetrics.ENCODE,
+        100L, 0L, 10L);
+    metrics.record("main", "allgather-1", CollectiveMetrics.ENCODE,
+        50L, 0L, 5L);
+    metrics.recordReceive("main", "allgather-1", 70L);
+    List<OpMetrics> opMetrics = metrics.getOpMetrics();
+    Assert.assertEquals(1, opMetrics.size());
+    OpMetrics allgather = opMetrics.get(0);
+    Assert.assertEquals("main/allgather", allgather.getKey());
+    Assert.assertEquals(2L, allgather.getCount(CollectiveMetrics.ENCODE));
+    Assert.assertEquals(15L, allgather.getNanos(CollectiveMetrics.ENCODE));
+    Assert.assertEquals(150L, allgather.getBytes(CollectiveMetrics.ENCODE));
+    Assert.assertEquals(70L, metrics.getTotalBytes(CollectiveMetrics.RECEIVE));
+  }
+
+  @Test
+  public void testStragglersAndCombine() {
+    CollectiveMetrics metrics = CollectiveMetrics.get();
+    metrics.recordWait("main", "reduce-0", 1, 0L, 10L);
+    metrics.recordWait("main", "reduce-0", 2, 0L, 30L);
+    metrics.recordWait("main", "rotate-0", 3, 0L, 20L);
+    metrics.recordCombine(0L, 7L);
+    Map<Integer, Long> stragglers = metrics.getStragglers(2);
+    Assert.assertArrayEquals(new Integer[] { 2, 3 },
+        stragglers.keySet().toArray(new Integer[0]));
+    Assert.assertEquals(30L, (long) stragglers.get(2));
+    Assert.assertEquals("main/reduce",
+        metrics.getTopOpMetrics(1).get(0).getKey());
+    // The combining goes to the last wait
+    OpMetrics rotate = metrics.getOpMetrics().get(1);
+    Assert.assertEquals("main/rotate", rotate.getKey());
+    Assert.assertEquals(7L, rotate.getNanos(CollectiveMetrics.COMBINE));
+  }
+
+  @Test
+  public void testTimedOutWait() {
+    CollectiveMetrics metrics = CollectiveMetrics.get();
+    metrics.recordWait("main", "allgather-0", 1, 0L, 10L);
+    metrics.recordWait("main", "allgather-1",
+        Constant.UNKNOWN_WORKER_ID, 0L, 50L);
+    Map<Integer, Long> stragglers = metrics.getStragglers(1);
+    Assert.assertEquals(50L,
+        (long) stragglers.get(Constant.UNKNOWN_WORKER_ID));
+    Assert.assertEquals(60L,
+        metrics.getTotalNanos(CollectiveMetrics.WAIT));
+  }
+
+  @Test
+  public void testWriteTrace() throws IOException {
+    CollectiveMetrics metrics = CollectiveMetrics.get();
+    metrics.setTracing(true);
+    metrics.record("main", "bcast-\"0\"", CollectiveMetrics.SEND, 8L,
+        0L, 2000L);
+    ByteArrayOutputStream out = new ByteArrayOutputStream();
+    metrics.writeTrace(out, 5);
+    String trace = new String(out.toByteArray(), StandardCharsets.UTF_8);
+    Assert.assertTrue(trace.startsWith("{\"traceEvents\":["));
+    Assert.assertTrue(trace.contains("\"name\":\"main/bcast-\\\"0\\\"\""));
+    Assert.assertTrue(trace.contains("\"cat\":\"send\""));
+    Assert.assertTrue(trace.contains("\"dur\":2,\"pid\":5"));
+    Assert.assertTrue(trace.contains("\"args\":{\"bytes\":8}"));
+  }
+}
@@ -0,0 +1,67 @@
+package edu.iu.harp.resource;
+
+import edu.iu.harp.util.Ack;
+import edu.iu.harp.util.Barrier;
+import edu.iu.harp.util.PartitionCount;
+import org.junit.Assert;
+import org.junit.Test;
+
+import java.util.Arrays;
+
+public class WritableRegistryTest {
+
+  @Test
+  public void testSameOrderSameHash() {
+    WritableRegistry registry1 = new WritableRegistry();
+    WritableRegistry registry2 = new WritableRegistry();
+    registry1.register(Ack.class);
+    registry1.register(Barrier.class);
+    registry2.register(Arrays.asList(Ack.class.getName(),
+        Barrier.class.getName()));
+    Assert.assertEquals(registry1.getClassNames(),
+        registry2.getClassNames());
+    Assert.assertEquals(registry1.getClassHash(),
+        registry2.getClassHash());
+  }
+
+  @Test
+  public void testDifferentOrderDifferentHash() {
+    WritableRegistry registry1 = new WritableRegistry();
+    WritableRegistry registry2 = new WritableRegistry();
+    registry1.register(Ack.class);
+    registry1.register(Barrier.class);
+    registry2.register(Barrier.class);
+    registry2.register(Ack.class);
+    // The same ID means different classes
+    Assert.assertEquals(registry1.getClassID(Ack.class),
+        registry2.getClassID(Barrier.class));
+    Assert.assertNotEquals(registry1.getClassHash(),
+        registry2.getClassHash());
+  }
+
+  @Test
+  public void testExtraClassDifferentHash() {
+    WritableRegistry registry1 = new WritableRegistry();
+    WritableRegistry registry2 = new WritableRegistry();
+    registry1.register(Ack.class);
+    registry2.register(Ack.class);
+    registry2.register(PartitionCount.class);
+    Assert.assertNotEquals(registry1.getClassHash(),
+        registry2.getClassHash());
+    registry2.reset();
+    Assert.assertNotEquals(registry1.getClassHash(),
+        registry2.getClassHash());
+    Assert.assertEquals(new WritableRegistry().getClassHash(),
+        registry2.getClassHash());
+  }
+
+  @Test
+  public void testRegisterNotWritable() {
+    WritableRegistry registry = new WritableRegistry();
+    Assert.assertFalse(registry.register(Arrays.asList(
+        Ack.class.getName(), String.class.getName())));
+    Assert.assertNull(registry.forName(String.class.getName()));
+    Assert.assertFalse(registry.register(
+        Arrays.asList("edu.iu.harp.util.NoSuchWritable")));
+  }
+}
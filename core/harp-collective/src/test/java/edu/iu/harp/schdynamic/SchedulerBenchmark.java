@@ -0,0 +1,152 @@
+package edu.iu.harp.schdynamic;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.runner.Runner;
+import org.openjdk.jmh.runner.options.OptionsBuilder;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Compare DynamicScheduler and WorkStealingScheduler on fine-grained tasks.
+ * Each benchmark starts only the scheduler it measures.
+ * Run with the test classpath:
+ * java -cp ... edu.iu.harp.schdynamic.SchedulerBenchmark
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 3, time = 2)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+public class SchedulerBenchmark {
+
+  /**
+   * A task doing a small amount of floating point work per input. The
+   * inputs are shared by all the iterations, so the sum goes to a new
+   * output array.
+   */
+  public static class BlockTask implements Task<double[], double[]> {
+    @Override
+    public double[] run(double[] input) throws Exception {
+      double sum = 0.0;
+      for (int i = 0; i < input.length; i++) {
+        sum += input[i] * input[i];
+      }
+      return new double[] {sum};
+    }
+  }
+
+  @State(Scope.Benchmark)
+  public abstract static class Inputs {
+    @Param({"4", "16", "32"})
+    public int numThreads;
+
+    @Param({"16", "1024"})
+    public int blockSize;
+
+    @Param({"10000"})
+    public int numInputs;
+
+    protected double[][] inputs;
+
+    protected void createInputs() {
+      inputs = new double[numInputs][blockSize];
+      for (int i = 0; i < numInputs; i++) {
+        for (int j = 0; j < blockSize; j++) {
+          inputs[i][j] = j;
+        }
+      }
+    }
+
+    protected List<BlockTask> createTasks() {
+      List<BlockTask> tasks = new ArrayList<>();
+      for (int i = 0; i < numThreads; i++) {
+        tasks.add(new BlockTask());
+      }
+      return tasks;
+    }
+  }
+
+  public static class DynamicState extends Inputs {
+    private DynamicScheduler<double[], double[], BlockTask> scheduler;
+
+    @Setup(Level.Trial)
+    public void setUp() {
+      createInputs();
+      scheduler = new DynamicScheduler<>(createTasks());
+      scheduler.start();
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() {
+      scheduler.stop();
+    }
+  }
+
+  public static class StealingState extends Inputs {
+    private WorkStealingScheduler<double[], double[], BlockTask> scheduler;
+
+    @Setup(Level.Trial)
+    public void setUp() {
+      createInputs();
+      scheduler = new WorkStealingScheduler<>(createTasks());
+      scheduler.start();
+    }
+
+    @TearDown(Level.Trial)
+    public void tearDown() {
+      scheduler.stop();
+    }
+  }
+
+  @Benchmark
+  public int dynamicScheduler(DynamicState state) {
+    state.scheduler.submitAll(state.inputs);
+    int count = 0;
+    while (state.scheduler.hasOutput()) {
+      state.scheduler.waitForOutput();
+      count++;
+    }
+    return count;
+  }
+
+  @Benchmark
+  public int stealingScheduler(StealingState state) {
+    state.scheduler.submitAll(state.inputs);
+    int count = 0;
+    while (state.scheduler.hasOutput()) {
+      state.scheduler.waitForOutput();
+      count++;
+    }
+    return count;
+  }
+
+  @Benchmark
+  public int stealingSchedulerDrain(StealingState state) {
+    state.scheduler.submitAll(state.inputs);
+    List<double[]> outputs = new ArrayList<>(state.numInputs);
+    int count = 0;
+    while (state.scheduler.hasOutput()) {
+      count += state.scheduler.drainOutputs(outputs);
+    }
+    return count;
+  }
+
+  public static void main(String[] args) throws Exception {
+    new Runner(new OptionsBuilder()
+        .include(SchedulerBenchmark.class.getSimpleName()).build()).run();
+  }
+}
@@ -0,0 +1,79 @@
+package edu.iu.harp.schdynamic;
+
+import org.junit.Assert;
+import org.junit.Test;
+
+import java.util.ArrayList;
+import java.util.List;
+
+public class WorkStealingSchedulerTest {
+
+  private static class SquareTask implements Task<Integer, Integer> {
+    @Override
+    public Integer run(Integer input) throws Exception {
+      if (input < 0) {
+        throw new Exception("negative input");
+      }
+      return input * input;
+    }
+  }
+
+  private List<SquareTask> createTasks(int numTasks) {
+    List<SquareTask> tasks = new ArrayList<>();
+    for (int i = 0; i < numTasks; i++) {
+      tasks.add(new SquareTask());
+    }
+    return tasks;
+  }
+
+  @Test
+  public void testSubmitAndWait() {
+    WorkStealingScheduler<Integer, Integer, SquareTask> scheduler =
+        new WorkStealingScheduler<>(createTasks(4));
+    for (int i = 0; i < 100; i++) {
+      scheduler.submit(i);
+    }
+    scheduler.start();
+    long sum = 0;
+    int count = 0;
+    while (scheduler.hasOutput()) {
+      sum += scheduler.waitForOutput();
+      count++;
+    }
+    scheduler.stop();
+
+    Assert.assertEquals(100, count);
+    Assert.assertEquals(328350, sum);
+    Assert.assertFalse(scheduler.hasError());
+    long numTasksRun = 0;
+    for (long n : scheduler.getNumTasksRun()) {
+      numTasksRun += n;
+    }
+    Assert.assertEquals(100, numTasksRun);
+  }
+
+  @Test
+  public void testBatchAndPause() {
+    WorkStealingScheduler<Integer, Integer, SquareTask> scheduler =
+        new WorkStealingScheduler<>(createTasks(3));
+    scheduler.start();
+    Integer[] inputs = new Integer[50];
+    for (int i = 0; i < inputs.length; i++) {
+      inputs[i] = i;
+    }
+    scheduler.submitAll(inputs);
+    scheduler.pause();
+    List<Integer> outputs = new ArrayList<>();
+    while (scheduler.hasOutput()) {
+      scheduler.drainOutputs(outputs);
+    }
+    Assert.assertEquals(50, outputs.size());
+
+    scheduler.submit(-1);
+    scheduler.start();
+    Assert.assertNull(scheduler.waitForOutput());
+    Assert.assertTrue(scheduler.hasError());
+    Assert.assertFalse(scheduler.hasOutput());
+    scheduler.stop();
+  }
+}
@@ -1,14 +1,26 @@
 package edu.iu.harp.server;
 
+import edu.iu.harp.client.DataSender;
+import edu.iu.harp.io.ConnPool;
+import edu.iu.harp.io.Constant;
+import edu.iu.harp.io.Data;
 import edu.iu.harp.io.DataMap;
+import edu.iu.harp.io.DataType;
+import edu.iu.harp.io.DataUtil;
 import edu.iu.harp.io.EventQueue;
+import edu.iu.harp.io.Transport;
+import edu.iu.harp.resource.DoubleArray;
+import edu.iu.harp.resource.Transferable;
 import edu.iu.harp.worker.Workers;
+import org.junit.Assert;
 import org.junit.Before;
 import org.junit.Test;
 
 import java.io.BufferedReader;
 import java.io.File;
 import java.io.FileReader;
+import java.util.LinkedList;
+import java.util.List;
 import java.util.Objects;
 
 public class ServerTest {
@@ -29,4 +41,41 @@ public class ServerTest {
     s.start();
     s.stop();
   }
+
+  @Test
+  public void testNioSend() throws Exception {
+    Workers workers = new Workers(new BufferedReader(new FileReader(fileName)), 0);
+    DataMap dataMap = new DataMap();
+    Transport.set(Transport.NIO);
+    try {
+      Server s = new Server("localhost", 10093, new EventQueue(), dataMap, workers);
+      s.start();
+      // The second array is larger than the direct buffer of the sender
+      int[] sizes = {1000, Constant.BUFFER_SIZE / 4};
+      for (int i = 0; i < 2; i++) {
+        DoubleArray array = DoubleArray.create(sizes[i], false);
+        array.get()[sizes[i] - 1] = i;
+        List<Transferable> objs = new LinkedList<>();
+        objs.add(array);
+        Data data = new Data(DataType.SIMPLE_LIST, "test", 0, objs,
+            DataUtil.getNumTransListBytes(objs), "nio-" + i);
+        Assert.assertTrue(new DataSender(data, "localhost", 10093,
+            Constant.SEND_DECODE).execute());
+        data.release();
+      }
+      for (int i = 0; i < 2; i++) {
+        Data recvData = dataMap.waitAndGetData("test", "nio-" + i, 10);
+        Assert.assertNotNull(recvData);
+        Assert.assertEquals(1, recvData.getBody().size());
+        DoubleArray array = (DoubleArray) recvData.getBody().get(0);
+        Assert.assertEquals(sizes[i], array.size());
+        Assert.assertEquals(i, array.get()[sizes[i] - 1], 0.0);
+        recvData.release();
+      }
+      ConnPool.get().clean();
+      s.stop();
+    } finally {
+      Transport.set(Transport.BIO);
+    }
+  }
 }
@@ -25,4 +25,19 @@ public class WorkerTest {
     Assert.assertEquals(workers.getMaxID(), 1);
     Assert.assertEquals(workers.getMiddleID(), 0);
   }
+
+  @Test
+  public void testNodeTopology() throws Exception {
+    Workers workers = new Workers(new BufferedReader(new FileReader(fileName)), 1);
+
+    Assert.assertEquals(workers.getNumNodes(), 1);
+    Assert.assertEquals(workers.getLocalWorkerIDs().size(), 2);
+    Assert.assertTrue(workers.isLocalWorker(0));
+    Assert.assertEquals(workers.getNodeLeaderID(), 0);
+    Assert.assertFalse(workers.isNodeLeader());
+
+    Workers leaders = workers.getNodeLeaders();
+    Assert.assertEquals(leaders.getNumWorkers(), 1);
+    Assert.assertFalse(leaders.isSelfInWorker());
+  }
 }
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2013-2018 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.datasource;
+
+/**
+ * @brief a range of rows in a dense Harp binary file, and the position
+ * of its first row in the loaded table
+ */
+public class BinaryRowRange {
+  private String fileName;
+  private HarpBinaryFormat header;
+  private long firstRow;
+  private int numRows;
+  private long tableRow;
+
+  public BinaryRowRange(String fileName, HarpBinaryFormat header, long firstRow, int numRows, long tableRow) {
+    this.fileName = fileName;
+    this.header = header;
+    this.firstRow = firstRow;
+    this.numRows = numRows;
+    this.tableRow = tableRow;
+  }
+
+  public String getFileName() {
+    return this.fileName;
+  }
+
+  public HarpBinaryFormat getHeader() {
+    return this.header;
+  }
+
+  public long getFirstRow() {
+    return this.firstRow;
+  }
+
+  public int getNumRows() {
+    return this.numRows;
+  }
+
+  public long getTableRow() {
+    return this.tableRow;
+  }
+
+  public long getByteOffset() {
+    return this.header.getRowOffset(this.firstRow);
+  }
+}
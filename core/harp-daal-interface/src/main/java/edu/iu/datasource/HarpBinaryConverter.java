@@ -0,0 +1,175 @@
+/*
+ * Copyright 2013-2018 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.datasource;
+
+import java.io.IOException;
+
+import org.apache.commons.logging.Log;
+import org.apache.commons.logging.LogFactory;
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.conf.Configured;
+import org.apache.hadoop.fs.FileSystem;
+import org.apache.hadoop.fs.Path;
+import org.apache.hadoop.mapred.JobConf;
+import org.apache.hadoop.mapreduce.Job;
+import org.apache.hadoop.mapreduce.Mapper;
+import org.apache.hadoop.mapreduce.lib.input.FileInputFormat;
+import org.apache.hadoop.mapreduce.lib.output.NullOutputFormat;
+import org.apache.hadoop.util.Tool;
+import org.apache.hadoop.util.ToolRunner;
+
+import edu.iu.fileformat.MultiFileInputFormat;
+
+/**
+ * @brief a map-only job converting the text inputs of HarpDAALDataSource
+ * into the Harp binary format, one output file per input file. The input
+ * files are spread over the mappers by MultiFileInputFormat. The input
+ * directory is read recursively and its subdirectories are mirrored under
+ * the output directory, so files with the same name do not overwrite
+ * each other.
+ *
+ * Usage: HarpBinaryConverter <input dir> <output dir> <num mappers>
+ * <dense|csr|coo> <sep> [nFeatures]
+ */
+public class HarpBinaryConverter extends Configured implements Tool {
+
+  protected static final Log LOG = LogFactory.getLog(HarpBinaryConverter.class);
+
+  public static final String LAYOUT = "harp.binary.layout";
+  public static final String INPUT_DIR = "harp.binary.input";
+  public static final String OUTPUT_DIR = "harp.binary.output";
+  public static final String SEP = "harp.binary.sep";
+  public static final String FEATURE_DIM = "harp.binary.features";
+
+  public static void main(String[] argv) throws Exception {
+    int res = ToolRunner.run(new Configuration(), new HarpBinaryConverter(), argv);
+    System.exit(res);
+  }
+
+  @Override
+  public int run(String[] args) throws Exception {//{{{
+
+    if (args.length < 5) {
+      System.err.println("Usage: HarpBinaryConverter <input dir> <output dir> <num mappers>"
+          + " <dense|csr|coo> <sep> [nFeatures]");
+      return -1;
+    }
+
+    Configuration conf = this.getConf();
+    Path inputPath = new Path(args[0]);
+    Path outputPath = new Path(args[1]);
+    int numMappers = Integer.parseInt(args[2]);
+    String layout = args[3];
+    conf.set(LAYOUT, layout);
+    conf.set(INPUT_DIR, inputPath.getFileSystem(conf).makeQualified(inputPath).toString());
+    conf.set(OUTPUT_DIR, outputPath.toString());
+    conf.set(SEP, args[4]);
+    if (layout.equals("dense")) {
+      if (args.length < 6) {
+        System.err.println("nFeatures is required for dense files");
+        return -1;
+      }
+      conf.setInt(FEATURE_DIM, Integer.parseInt(args[5]));
+    }
+
+    FileSystem fs = outputPath.getFileSystem(conf);
+    fs.mkdirs(outputPath);
+
+    Job job = Job.getInstance(conf, "harp-binary-convert");
+    JobConf jobConf = (JobConf) job.getConfiguration();
+    jobConf.setNumMapTasks(numMappers);
+    job.setNumReduceTasks(0);
+    FileInputFormat.setInputPaths(job, inputPath);
+    FileInputFormat.setInputDirRecursive(job, true);
+    job.setInputFormatClass(MultiFileInputFormat.class);
+    job.setOutputFormatClass(NullOutputFormat.class);
+    job.setJarByClass(HarpBinaryConverter.class);
+    job.setMapperClass(ConvertMapper.class);
+
+    boolean jobSuccess = job.waitForCompletion(true);
+    if (!jobSuccess) {
+      LOG.error("Harp binary conversion failed");
+      return 1;
+    }
+
+    return 0;
+  }//}}}
+
+  /**
+   * @brief the output file of an input file, at the same path relative to
+   * the output directory as the input file is to the input directory.
+   * An input file given as the input directory keeps its name. A file
+   * outside of the input directory, e.g. matched by a glob, keeps its
+   * whole path under the output directory.
+   */
+  public static String getOutputFile(String inputDir, String inputFile, String outputDir) {//{{{
+    String root = new Path(inputDir).toUri().getPath();
+    String file = new Path(inputFile).toUri().getPath();
+    String relative;
+    if (file.equals(root))
+      relative = new Path(file).getName();
+    else if (file.startsWith(root + Path.SEPARATOR))
+      relative = file.substring(root.length() + 1);
+    else
+      relative = file.substring(1);
+    return new Path(outputDir, relative).toString();
+  }//}}}
+
+  /**
+   * @brief convert each input file of the split
+   */
+  public static class ConvertMapper extends Mapper<String, String, Object, Object> {
+
+    private String layout;
+    private String inputDir;
+    private String outputDir;
+    private String sep;
+    private int nFeatures;
+
+    @Override
+    protected void setup(Context context) {
+      Configuration conf = context.getConfiguration();
+      this.layout = conf.get(LAYOUT, "dense");
+      this.inputDir = conf.get(INPUT_DIR);
+      this.outputDir = conf.get(OUTPUT_DIR);
+      this.sep = conf.get(SEP, ",");
+      this.nFeatures = conf.getInt(FEATURE_DIM, 0);
+    }
+
+    @Override
+    protected void map(String key, String value, Context context) throws IOException {//{{{
+
+      Configuration conf = context.getConfiguration();
+      String outputFile = getOutputFile(this.inputDir, value, this.outputDir);
+      long startTime = System.currentTimeMillis();
+      HarpBinaryFormat header = null;
+      if (this.layout.equals("dense"))
+        header = HarpBinaryWriter.convertDenseCSV(value, outputFile, this.nFeatures, this.sep, conf);
+      else if (this.layout.equals("csr"))
+        header = HarpBinaryWriter.convertCSR(value, outputFile, this.sep, conf);
+      else if (this.layout.equals("coo"))
+        header = HarpBinaryWriter.convertCOO(value, outputFile, this.sep, conf);
+      else
+        throw new IOException("Unknown layout " + this.layout);
+
+      LOG.info("Convert " + value + " to " + outputFile + ", rows " + header.getNumRows()
+          + ", cols " + header.getNumCols() + ", nnz " + header.getNumNonZeros()
+          + ", time (ms) " + (System.currentTimeMillis() - startTime));
+      context.progress();
+    }//}}}
+  }
+}
@@ -0,0 +1,221 @@
+/*
+ * Copyright 2013-2018 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.datasource;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.fs.FSDataInputStream;
+import org.apache.hadoop.fs.FileSystem;
+import org.apache.hadoop.fs.Path;
+
+/**
+ * @brief the header of the Harp binary dataset format
+ *
+ * A file starts with a fixed 64-byte little-endian header, followed by
+ * fixed-width sections, so any row range maps to a byte range:
+ * DENSE: row-major double[nRows * nCols]
+ * CSR:   long[nRows + 1] row offsets (1-based), long[nnz] column indices
+ *        (1-based), double[nnz] values, then optional double[nRows] labels
+ * COO:   long[nnz] row IDs, long[nnz] column IDs, double[nnz] values
+ */
+public class HarpBinaryFormat {
+
+  // "HARPBIN1" in little-endian
+  public static final long MAGIC = 0x314E494250524148L;
+  public static final int VERSION = 1;
+  public static final int HEADER_SIZE = 64;
+  public static final int VALUE_SIZE = 8;
+
+  public static final int DENSE = 0;
+  public static final int CSR = 1;
+  public static final int COO = 2;
+
+  public static final int FLAG_LABELS = 1;
+
+  private int layout;
+  private int flags;
+  private long nRows;
+  private long nCols;
+  private long nnz;
+
+  public HarpBinaryFormat(int layout, long nRows, long nCols, long nnz, int flags) {
+    this.layout = layout;
+    this.nRows = nRows;
+    this.nCols = nCols;
+    this.nnz = nnz;
+    this.flags = flags;
+  }
+
+  public static HarpBinaryFormat dense(long nRows, long nCols) {//{{{
+    return new HarpBinaryFormat(DENSE, nRows, nCols, nRows * nCols, 0);
+  }//}}}
+
+  public static HarpBinaryFormat csr(long nRows, long nCols, long nnz, boolean withLabels) {//{{{
+    return new HarpBinaryFormat(CSR, nRows, nCols, nnz, withLabels ? FLAG_LABELS : 0);
+  }//}}}
+
+  public static HarpBinaryFormat coo(long nRows, long nCols, long nnz) {//{{{
+    return new HarpBinaryFormat(COO, nRows, nCols, nnz, 0);
+  }//}}}
+
+  public int getLayout() {
+    return this.layout;
+  }
+
+  public long getNumRows() {
+    return this.nRows;
+  }
+
+  public long getNumCols() {
+    return this.nCols;
+  }
+
+  public long getNumNonZeros() {
+    return this.nnz;
+  }
+
+  public boolean hasLabels() {
+    return (this.flags & FLAG_LABELS) != 0;
+  }
+
+  // ------------------------------  section offsets ------------------------------
+
+  /**
+   * @brief byte offset of the first value of a dense row
+   */
+  public long getRowOffset(long row) {
+    return HEADER_SIZE + row * this.nCols * VALUE_SIZE;
+  }
+
+  /**
+   * @brief byte offset of the CSR row offsets or of the COO row IDs
+   */
+  public long getRowIndexOffset() {
+    return HEADER_SIZE;
+  }
+
+  /**
+   * @brief byte offset of the CSR or COO column indices
+   */
+  public long getColIndexOffset() {
+    if (this.layout == CSR)
+      return HEADER_SIZE + (this.nRows + 1) * VALUE_SIZE;
+    else
+      return HEADER_SIZE + this.nnz * VALUE_SIZE;
+  }
+
+  /**
+   * @brief byte offset of the CSR or COO values
+   */
+  public long getValueOffset() {
+    return getColIndexOffset() + this.nnz * VALUE_SIZE;
+  }
+
+  /**
+   * @brief byte offset of the CSR labels
+   */
+  public long getLabelOffset() {
+    return getValueOffset() + this.nnz * VALUE_SIZE;
+  }
+
+  /**
+   * @brief the expected file length in bytes
+   */
+  public long getFileLength() {//{{{
+    if (this.layout == DENSE)
+      return getRowOffset(this.nRows);
+    else if (hasLabels())
+      return getLabelOffset() + this.nRows * VALUE_SIZE;
+    else
+      return getValueOffset() + this.nnz * VALUE_SIZE;
+  }//}}}
+
+  // ------------------------------  serialization ------------------------------
+
+  public ByteBuffer toByteBuffer() {//{{{
+    ByteBuffer buf = ByteBuffer.allocate(HEADER_SIZE).order(ByteOrder.LITTLE_ENDIAN);
+    buf.putLong(MAGIC);
+    buf.putInt(VERSION);
+    buf.putInt(this.layout);
+    buf.putInt(this.flags);
+    buf.putInt(VALUE_SIZE);
+    buf.putLong(this.nRows);
+    buf.putLong(this.nCols);
+    buf.putLong(this.nnz);
+    // the rest is reserved
+    buf.position(0);
+    return buf;
+  }//}}}
+
+  public static HarpBinaryFormat fromByteBuffer(ByteBuffer buf) throws IOException {//{{{
+    buf.order(ByteOrder.LITTLE_ENDIAN);
+    if (buf.remaining() < HEADER_SIZE || buf.getLong() != MAGIC)
+      throw new IOException("Not a Harp binary file");
+
+    int version = buf.getInt();
+    if (version != VERSION)
+      throw new IOException("Unsupported Harp binary version " + version);
+
+    int layout = buf.getInt();
+    int flags = buf.getInt();
+    int valueSize = buf.getInt();
+    if (valueSize != VALUE_SIZE)
+      throw new IOException("Unsupported value width " + valueSize);
+
+    long nRows = buf.getLong();
+    long nCols = buf.getLong();
+    long nnz = buf.getLong();
+    return new HarpBinaryFormat(layout, nRows, nCols, nnz, flags);
+  }//}}}
+
+  /**
+   * @brief read the header of a file, null if it is not a Harp binary file
+   */
+  public static HarpBinaryFormat readHeader(Path path, Configuration conf) throws IOException {//{{{
+    FileSystem fs = path.getFileSystem(conf);
+    if (fs.getFileStatus(path).getLen() < HEADER_SIZE)
+      return null;
+
+    byte[] bytes = new byte[HEADER_SIZE];
+    FSDataInputStream in = fs.open(path);
+    try {
+      in.readFully(0, bytes);
+    } finally {
+      in.close();
+    }
+
+    ByteBuffer buf = ByteBuffer.wrap(bytes).order(ByteOrder.LITTLE_ENDIAN);
+    if (buf.getLong(0) != MAGIC)
+      return null;
+
+    return fromByteBuffer(buf);
+  }//}}}
+
+  /**
+   * @brief check if the file is in the Harp binary format
+   */
+  public static boolean isBinaryFile(String file, Configuration conf) {//{{{
+    try {
+      return readHeader(new Path(file), conf) != null;
+    } catch (IOException e) {
+      return false;
+    }
+  }//}}}
+}
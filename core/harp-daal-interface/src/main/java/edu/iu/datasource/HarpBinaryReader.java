@@ -0,0 +1,255 @@
+/*
+ * Copyright 2013-2018 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.datasource;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.util.ArrayList;
+import java.util.EnumSet;
+import java.util.LinkedList;
+import java.util.List;
+
+import org.apache.commons.logging.Log;
+import org.apache.commons.logging.LogFactory;
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.fs.FSDataInputStream;
+import org.apache.hadoop.fs.FileSystem;
+import org.apache.hadoop.fs.Path;
+import org.apache.hadoop.fs.ReadOption;
+import org.apache.hadoop.io.ElasticByteBufferPool;
+
+/**
+ * @brief read byte ranges of a Harp binary file into primitive arrays
+ *
+ * Reads go through the HDFS enhanced byte buffer API. When short-circuit
+ * local reads are enabled and the block is on this node, HDFS returns a
+ * memory-mapped buffer of the block file, so values are copied once from
+ * the page cache into the destination array. Otherwise HDFS falls back to
+ * a pooled buffer. Values are never parsed or boxed.
+ */
+public class HarpBinaryReader implements Closeable {
+
+  protected static final Log LOG = LogFactory
+      .getLog(HarpBinaryReader.class);
+
+  // the max bytes requested per zero-copy read
+  private static final int MAX_READ_SIZE = 1 << 24;
+  // the rows read at a time by readDenseRows
+  private static final int READ_ROWS = 1 << 16;
+
+  private static final EnumSet<ReadOption> READ_OPTIONS =
+      EnumSet.of(ReadOption.SKIP_CHECKSUMS);
+
+  private final FSDataInputStream in;
+  private final ElasticByteBufferPool pool;
+  // holds a value split across two buffers
+  private final ByteBuffer carry;
+  private final int maxReadSize;
+
+  public HarpBinaryReader(Path path, Configuration conf) throws IOException {
+    this(path, conf, MAX_READ_SIZE);
+  }
+
+  // a small maxReadSize splits values across buffers, for testing
+  HarpBinaryReader(Path path, Configuration conf, int maxReadSize) throws IOException {
+    FileSystem fs = path.getFileSystem(conf);
+    this.in = fs.open(path);
+    this.pool = new ElasticByteBufferPool();
+    this.carry = ByteBuffer.allocate(HarpBinaryFormat.VALUE_SIZE)
+        .order(ByteOrder.LITTLE_ENDIAN);
+    this.maxReadSize = maxReadSize;
+  }
+
+  /**
+   * @param offset the byte offset in the file
+   * @param dst    the destination array
+   * @param dstPos the first position in dst
+   * @param count  the number of values
+   * @brief read count doubles starting from offset
+   */
+  public void readDoubles(long offset, double[] dst, int dstPos, int count) throws IOException {//{{{
+    in.seek(offset);
+    int pos = dstPos;
+    int end = dstPos + count;
+    this.carry.clear();
+    while (pos < end) {
+      ByteBuffer buf = nextBuffer((long) (end - pos) * HarpBinaryFormat.VALUE_SIZE);
+      try {
+        if (this.carry.position() > 0) {
+          if (!fillCarry(buf))
+            continue;
+          dst[pos++] = this.carry.getDouble(0);
+          this.carry.clear();
+        }
+        int n = Math.min(buf.remaining() / HarpBinaryFormat.VALUE_SIZE, end - pos);
+        buf.asDoubleBuffer().get(dst, pos, n);
+        buf.position(buf.position() + n * HarpBinaryFormat.VALUE_SIZE);
+        pos += n;
+        if (pos < end)
+          this.carry.put(buf);
+      } finally {
+        in.releaseBuffer(buf);
+      }
+    }
+  }//}}}
+
+  /**
+   * @brief read count longs starting from offset
+   */
+  public void readLongs(long offset, long[] dst, int dstPos, int count) throws IOException {//{{{
+    in.seek(offset);
+    int pos = dstPos;
+    int end = dstPos + count;
+    this.carry.clear();
+    while (pos < end) {
+      ByteBuffer buf = nextBuffer((long) (end - pos) * HarpBinaryFormat.VALUE_SIZE);
+      try {
+        if (this.carry.position() > 0) {
+          if (!fillCarry(buf))
+            continue;
+          dst[pos++] = this.carry.getLong(0);
+          this.carry.clear();
+        }
+        int n = Math.min(buf.remaining() / HarpBinaryFormat.VALUE_SIZE, end - pos);
+        buf.asLongBuffer().get(dst, pos, n);
+        buf.position(buf.position() + n * HarpBinaryFormat.VALUE_SIZE);
+        pos += n;
+        if (pos < end)
+          this.carry.put(buf);
+      } finally {
+        in.releaseBuffer(buf);
+      }
+    }
+  }//}}}
+
+  private ByteBuffer nextBuffer(long remaining) throws IOException {//{{{
+    int maxLength = (int) Math.min(remaining, this.maxReadSize);
+    ByteBuffer buf = in.read(this.pool, maxLength, READ_OPTIONS);
+    if (buf == null)
+      throw new IOException("Unexpected end of Harp binary file");
+
+    buf.order(ByteOrder.LITTLE_ENDIAN);
+    return buf;
+  }//}}}
+
+  /**
+   * @brief complete a split value, true if the carry holds a full value
+   */
+  private boolean fillCarry(ByteBuffer buf) {//{{{
+    while (this.carry.hasRemaining() && buf.hasRemaining())
+      this.carry.put(buf.get());
+
+    return !this.carry.hasRemaining();
+  }//}}}
+
+  // ------------------------------  whole file loaders ------------------------------
+
+  /**
+   * @param file       the dense binary file
+   * @param header     the header of the file
+   * @param valperline the expected number of values per row
+   * @param shardsize  the number of rows per shard
+   * @brief read all the rows of a dense binary file as shards of rows, the
+   * same output as the CSV readers
+   */
+  public static List<double[][]> readDenseShards(String file, HarpBinaryFormat header, int valperline,
+                                                 int shardsize, Configuration conf) throws IOException {//{{{
+
+    checkLayout(file, header, HarpBinaryFormat.DENSE);
+    if (header.getNumCols() != valperline)
+      throw new IOException("Expect " + valperline + " values per row, but "
+          + file + " has " + header.getNumCols());
+
+    List<double[][]> outputlist = new LinkedList<>();
+    double[] buffer = new double[shardsize * valperline];
+    HarpBinaryReader reader = new HarpBinaryReader(new Path(file), conf);
+    try {
+      long nRows = header.getNumRows();
+      for (long row = 0; row < nRows; row += shardsize) {
+        int numRows = (int) Math.min(shardsize, nRows - row);
+        reader.readDoubles(header.getRowOffset(row), buffer, 0, numRows * valperline);
+        double[][] shard = new double[numRows][];
+        for (int j = 0; j < numRows; j++) {
+          shard[j] = new double[valperline];
+          System.arraycopy(buffer, j * valperline, shard[j], 0, valperline);
+        }
+        outputlist.add(shard);
+      }
+    } finally {
+      reader.close();
+    }
+
+    return outputlist;
+  }//}}}
+
+  /**
+   * @brief read all the rows of a dense binary file, one array per row,
+   * the same output as ReadDenseCSVTask
+   */
+  public static List<double[]> readDenseRows(String file, HarpBinaryFormat header, int valperline,
+                                             Configuration conf) throws IOException {//{{{
+
+    List<double[]> points = new LinkedList<>();
+    for (double[][] shard : readDenseShards(file, header, valperline, READ_ROWS, conf)) {
+      for (double[] cell : shard)
+        points.add(cell);
+    }
+
+    return points;
+  }//}}}
+
+  /**
+   * @brief read all the entries of a COO binary file
+   */
+  public static List<COO> readCOO(String file, HarpBinaryFormat header, Configuration conf) throws IOException {//{{{
+
+    checkLayout(file, header, HarpBinaryFormat.COO);
+    if (header.getNumNonZeros() > Integer.MAX_VALUE)
+      throw new IOException("Too many entries in " + file);
+
+    int nnz = (int) header.getNumNonZeros();
+    long[] rowIds = new long[nnz];
+    long[] colIds = new long[nnz];
+    double[] vals = new double[nnz];
+    HarpBinaryReader reader = new HarpBinaryReader(new Path(file), conf);
+    try {
+      reader.readLongs(header.getRowIndexOffset(), rowIds, 0, nnz);
+      reader.readLongs(header.getColIndexOffset(), colIds, 0, nnz);
+      reader.readDoubles(header.getValueOffset(), vals, 0, nnz);
+    } finally {
+      reader.close();
+    }
+
+    List<COO> points = new ArrayList<>(nnz);
+    for (int j = 0; j < nnz; j++)
+      points.add(new COO(rowIds[j], colIds[j], vals[j]));
+
+    return points;
+  }//}}}
+
+  static void checkLayout(String file, HarpBinaryFormat header, int layout) throws IOException {//{{{
+    if (header.getLayout() != layout)
+      throw new IOException("Unexpected layout " + header.getLayout() + " of " + file);
+  }//}}}
+
+  @Override
+  public void close() throws IOException {
+    in.close();
+  }
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright 2013-2018 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.datasource;
+
+import java.io.BufferedReader;
+import java.io.Closeable;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.InputStreamReader;
+import java.io.OutputStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+import org.apache.commons.logging.Log;
+import org.apache.commons.logging.LogFactory;
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.fs.FileSystem;
+import org.apache.hadoop.fs.Path;
+
+/**
+ * @brief write Harp binary files, and convert the text formats read by
+ * HarpDAALDataSource into them
+ */
+public class HarpBinaryWriter implements Closeable {
+
+  protected static final Log LOG = LogFactory
+      .getLog(HarpBinaryWriter.class);
+
+  private static final int BUFFER_SIZE = 1 << 20;
+
+  private final OutputStream out;
+  private final ByteBuffer buffer;
+
+  public HarpBinaryWriter(OutputStream out, HarpBinaryFormat header) throws IOException {
+    this.out = out;
+    this.buffer = ByteBuffer.allocate(BUFFER_SIZE).order(ByteOrder.LITTLE_ENDIAN);
+    this.buffer.put(header.toByteBuffer());
+  }
+
+  public void writeDouble(double val) throws IOException {
+    if (this.buffer.remaining() < HarpBinaryFormat.VALUE_SIZE)
+      flush();
+
+    this.buffer.putDouble(val);
+  }
+
+  public void writeLong(long val) throws IOException {
+    if (this.buffer.remaining() < HarpBinaryFormat.VALUE_SIZE)
+      flush();
+
+    this.buffer.putLong(val);
+  }
+
+  public void writeDoubles(double[] vals, int offset, int count) throws IOException {
+    for (int j = offset; j < offset + count; j++)
+      writeDouble(vals[j]);
+  }
+
+  public void writeLongs(long[] vals, int offset, int count) throws IOException {
+    for (int j = offset; j < offset + count; j++)
+      writeLong(vals[j]);
+  }
+
+  public void flush() throws IOException {
+    this.out.write(this.buffer.array(), 0, this.buffer.position());
+    this.buffer.clear();
+  }
+
+  @Override
+  public void close() throws IOException {
+    flush();
+    this.out.close();
+  }
+
+  // ------------------------------  text converters ------------------------------
+
+  /**
+   * @param inputFile  the dense CSV file, one row per line
+   * @param outputFile the binary file
+   * @param nFeatures  the number of values per row
+   * @param sep        the separator
+   * @brief convert a dense CSV file, rows are counted in a first pass so
+   * the header can be written before the values
+   */
+  public static HarpBinaryFormat convertDenseCSV(String inputFile, String outputFile, int nFeatures,
+                                                 String sep, Configuration conf)
+      throws IOException {//{{{
+
+    Path inputPath = new Path(inputFile);
+    FileSystem fs = inputPath.getFileSystem(conf);
+    long nRows = countLines(fs, inputPath);
+
+    HarpBinaryFormat header = HarpBinaryFormat.dense(nRows, nFeatures);
+
+    Path outputPath = new Path(outputFile);
+    HarpBinaryWriter writer = new HarpBinaryWriter(
+        outputPath.getFileSystem(conf).create(outputPath, true), header);
+    BufferedReader reader = new BufferedReader(new InputStreamReader(fs.open(inputPath)));
+
+    try {
+      double[] row = new double[nFeatures];
+      long rowID = 0;
+      String line = null;
+      while ((line = reader.readLine()) != null && rowID < nRows) {
+        if (line.isEmpty())
+          continue;
+
+        String[] lineData = line.split(sep);
+        for (int t = 0; t < nFeatures; t++)
+          row[t] = Double.parseDouble(lineData[t]);
+
+        writer.writeDoubles(row, 0, nFeatures);
+        rowID++;
+      }
+
+      if (rowID != nRows)
+        throw new IOException("File changed during conversion " + inputFile);
+
+    } finally {
+      reader.close();
+      writer.close();
+    }
+
+    return header;
+  }//}}}
+
+  /**
+   * @brief convert a CSR file with three lines, row offsets, column
+   * indices and values, followed by optional labels, one per line, the
+   * same as loadCSRNumericTable and loadCSRNumericTableAndLabel
+   */
+  public static HarpBinaryFormat convertCSR(String inputFile, String outputFile, String sep,
+                                            Configuration conf) throws IOException {//{{{
+
+    Path inputPath = new Path(inputFile);
+    FileSystem fs = inputPath.getFileSystem(conf);
+    BufferedReader reader = new BufferedReader(new InputStreamReader(fs.open(inputPath)));
+
+    String[] rowOffsets = null;
+    String[] colIndices = null;
+    String[] values = null;
+    double[] labels = null;
+    try {
+      rowOffsets = splitLine(reader.readLine(), sep);
+      colIndices = splitLine(reader.readLine(), sep);
+      values = splitLine(reader.readLine(), sep);
+      if (rowOffsets.length < 2 || colIndices.length != values.length)
+        throw new IOException("Unable to read input dataset " + inputFile);
+
+      String line = reader.readLine();
+      if (line != null && !line.isEmpty()) {
+        labels = new double[rowOffsets.length - 1];
+        for (int j = 0; j < labels.length && line != null; j++) {
+          labels[j] = Double.parseDouble(line.split(sep)[0]);
+          line = reader.readLine();
+        }
+      }
+    } finally {
+      reader.close();
+    }
+
+    long nRows = rowOffsets.length - 1;
+    long nnz = values.length;
+
+    long maxCol = 0;
+    for (int j = 0; j < colIndices.length; j++)
+      maxCol = Math.max(maxCol, Long.parseLong(colIndices[j]));
+
+    HarpBinaryFormat header = HarpBinaryFormat.csr(nRows, maxCol, nnz, labels != null);
+    Path outputPath = new Path(outputFile);
+    HarpBinaryWriter writer = new HarpBinaryWriter(
+        outputPath.getFileSystem(conf).create(outputPath, true), header);
+
+    try {
+      for (int j = 0; j < rowOffsets.length; j++)
+        writer.writeLong(Long.parseLong(rowOffsets[j]));
+
+      for (int j = 0; j < colIndices.length; j++)
+        writer.writeLong(Long.parseLong(colIndices[j]));
+
+      for (int j = 0; j < values.length; j++)
+        writer.writeDouble(Double.parseDouble(values[j]));
+
+      if (labels != null)
+        writer.writeDoubles(labels, 0, labels.length);
+
+    } finally {
+      writer.close();
+    }
+
+    return header;
+  }//}}}
+
+  /**
+   * @brief convert a COO file with one "row col val" entry per line, the
+   * three fields are written as separate columns
+   */
+  public static HarpBinaryFormat convertCOO(String inputFile, String outputFile, String regex,
+                                            Configuration conf) throws IOException {//{{{
+
+    Path inputPath = new Path(inputFile);
+    FileSystem fs = inputPath.getFileSystem(conf);
+    long nnz = countLines(fs, inputPath);
+    if (nnz > Integer.MAX_VALUE)
+      throw new IOException("Too many entries in " + inputFile);
+
+    long[] rowIds = new long[(int) nnz];
+    long[] colIds = new long[(int) nnz];
+    double[] vals = new double[(int) nnz];
+    long maxRow = 0;
+    long maxCol = 0;
+
+    BufferedReader reader = new BufferedReader(new InputStreamReader(fs.open(inputPath)));
+    int count = 0;
+    try {
+      String line = null;
+      while ((line = reader.readLine()) != null && count < nnz) {
+        if (line.isEmpty())
+          continue;
+
+        String[] lineData = line.split(regex);
+        rowIds[count] = Long.parseLong(lineData[0]);
+        colIds[count] = Long.parseLong(lineData[1]);
+        vals[count] = Double.parseDouble(lineData[2]);
+        maxRow = Math.max(maxRow, rowIds[count]);
+        maxCol = Math.max(maxCol, colIds[count]);
+        count++;
+      }
+    } finally {
+      reader.close();
+    }
+
+    if (count != nnz)
+      throw new IOException("File changed during conversion " + inputFile);
+
+    HarpBinaryFormat header = HarpBinaryFormat.coo(maxRow, maxCol, nnz);
+    Path outputPath = new Path(outputFile);
+    HarpBinaryWriter writer = new HarpBinaryWriter(
+        outputPath.getFileSystem(conf).create(outputPath, true), header);
+
+    try {
+      writer.writeLongs(rowIds, 0, count);
+      writer.writeLongs(colIds, 0, count);
+      writer.writeDoubles(vals, 0, count);
+    } finally {
+      writer.close();
+    }
+
+    return header;
+  }//}}}
+
+  private static String[] splitLine(String line, String sep) throws IOException {//{{{
+    if (line == null)
+      throw new IOException("Unable to read input dataset");
+
+    return line.split(sep);
+  }//}}}
+
+  /**
+   * @brief count the non-empty lines of a text file without decoding it
+   */
+  private static long countLines(FileSystem fs, Path path) throws IOException {//{{{
+    byte[] buf = new byte[1 << 16];
+    long count = 0;
+    boolean inLine = false;
+    InputStream in = fs.open(path);
+    try {
+      int n = 0;
+      while ((n = in.read(buf)) > 0) {
+        for (int j = 0; j < n; j++) {
+          if (buf[j] == '\n') {
+            if (inLine)
+              count++;
+
+            inLine = false;
+          } else if (buf[j] != '\r')
+            inLine = true;
+        }
+      }
+    } finally {
+      in.close();
+    }
+
+    if (inLine)
+      count++;
+
+    return count;
+  }//}}}
+}
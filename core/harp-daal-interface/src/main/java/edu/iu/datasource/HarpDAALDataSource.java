@@ -77,6 +77,10 @@ public class HarpDAALDataSource {
 
     try {
 
+      List<HarpBinaryFormat> headers = MTReader.readBinaryHeaders(inputFiles, this.conf);
+      if (headers != null)
+        return this.createDenseNumericTableBinary(inputFiles, headers, nFeatures, context);
+
       //load in data block
       List<double[]> inputData = this.loadDenseCSVFiles(inputFiles, nFeatures, sep);
 
@@ -107,8 +111,13 @@ public class HarpDAALDataSource {
 
     try {
 
+      List<String> inputFileList = this.listInputFiles(inputFile);
+      List<HarpBinaryFormat> headers = MTReader.readBinaryHeaders(inputFileList, this.conf);
+      if (headers != null)
+        return this.createDenseNumericTableBinary(inputFileList, headers, nFeatures, context);
+
       //load in data block
-      List<double[]> inputData = this.loadDenseCSVFiles(inputFile, nFeatures, sep);
+      List<double[]> inputData = this.readDenseFileList(inputFileList, nFeatures, sep);
 
       // create daal table
       NumericTable inputTable = new HomogenNumericTable(context, Double.class, nFeatures, inputData.size(), NumericTable.AllocationFlag.DoAllocate);
@@ -127,6 +136,10 @@ public class HarpDAALDataSource {
 
     try {
 
+      List<HarpBinaryFormat> headers = MTReader.readBinaryHeaders(inputFiles, this.conf);
+      if (headers != null)
+        return this.createDenseNumericTableSplitBinary(inputFiles, headers, nFeature1, nFeature2, context);
+
       //load in data block
       List<double[]> inputData = this.loadDenseCSVFiles(inputFiles, (nFeature1 + nFeature2), sep);
 
@@ -154,8 +167,13 @@ public class HarpDAALDataSource {
 
     try {
 
+      List<String> inputFileList = this.listInputFiles(inputFile);
+      List<HarpBinaryFormat> headers = MTReader.readBinaryHeaders(inputFileList, this.conf);
+      if (headers != null)
+        return this.createDenseNumericTableSplitBinary(inputFileList, headers, nFeature1, nFeature2, context);
+
       //load in data block
-      List<double[]> inputData = this.loadDenseCSVFiles(inputFile, (nFeature1 + nFeature2), sep);
+      List<double[]> inputData = this.readDenseFileList(inputFileList, (nFeature1 + nFeature2), sep);
 
       // create daal table
       NumericTable[] inputTable = new NumericTable[2];
@@ -213,26 +231,24 @@ public class HarpDAALDataSource {
 
   public List<double[]> loadDenseCSVFiles(String inputFile, int nFeatures, String sep) {//{{{
 
-    Path inputFilePaths = new Path(inputFile);
     List<String> inputFileList = new LinkedList<>();
 
     try {
-      FileSystem fs =
-          inputFilePaths.getFileSystem(conf);
-      RemoteIterator<LocatedFileStatus> iterator =
-          fs.listFiles(inputFilePaths, true);
-
-      while (iterator.hasNext()) {
-        String name =
-            iterator.next().getPath().toUri()
-                .toString();
-        inputFileList.add(name);
-      }
-
+      inputFileList = this.listInputFiles(inputFile);
     } catch (IOException e) {
       LOG.error("Fail to get test files", e);
     }
 
+    return this.readDenseFileList(inputFileList, nFeatures, sep);
+
+  }//}}}
+
+  /**
+   * @brief read the listed dense files one by one, a binary file among
+   * them is read without parsing
+   */
+  private List<double[]> readDenseFileList(List<String> inputFileList, int nFeatures, String sep) {//{{{
+
     List<double[]> points = new LinkedList<double[]>();
 
     FSDataInputStream in = null;
@@ -246,6 +262,12 @@ public class HarpDAALDataSource {
       Path file_path = new Path(file_name);
       try {
 
+        HarpBinaryFormat header = HarpBinaryFormat.readHeader(file_path, conf);
+        if (header != null) {
+          points.addAll(HarpBinaryReader.readDenseRows(file_name, header, nFeatures, conf));
+          continue;
+        }
+
         FileSystem fs =
             file_path.getFileSystem(conf);
         in = fs.open(file_path);
@@ -312,6 +334,91 @@ public class HarpDAALDataSource {
 
   }//}}}
 
+  // ------------------------------  Dense binary files I/O ------------------------------
+
+  /**
+   * @param inputFiles dense files in the Harp binary format
+   * @param nFeatures
+   * @param context
+   * @return
+   * @brief load dense binary files into a NumericTable. Row ranges of the
+   * files are read in parallel and copied into the table block by block,
+   * without parsing or per-row allocation.
+   */
+  public NumericTable createDenseNumericTableBinary(List<String> inputFiles, int nFeatures, DaalContext context) throws IOException {//{{{
+    return createDenseNumericTableBinary(inputFiles, readHeaders(inputFiles), nFeatures, context);
+  }//}}}
+
+  /**
+   * @param headers the headers of inputFiles, from MTReader.readBinaryHeaders
+   */
+  public NumericTable createDenseNumericTableBinary(List<String> inputFiles, List<HarpBinaryFormat> headers, int nFeatures, DaalContext context) throws IOException {//{{{
+
+    MTReader reader = new MTReader();
+    List<BinaryRowRange> ranges = reader.splitDenseBinary(inputFiles, headers, nFeatures, MTReader.getBinaryRangeRows(nFeatures));
+
+    NumericTable inputTable = new HomogenNumericTable(context, Double.class, nFeatures, reader.getTotalLines(), NumericTable.AllocationFlag.DoAllocate);
+
+    if (!reader.readDenseBinary(ranges, nFeatures, inputTable, this.conf, this.harpthreads))
+      throw new IOException("Fail to load dense binary files");
+
+    LOG.info("Finish loading " + reader.getTotalLines() + " rows from binary files");
+    return inputTable;
+  }//}}}
+
+  public NumericTable[] createDenseNumericTableSplitBinary(List<String> inputFiles, int nFeature1, int nFeature2, DaalContext context) throws IOException {//{{{
+    return createDenseNumericTableSplitBinary(inputFiles, readHeaders(inputFiles), nFeature1, nFeature2, context);
+  }//}}}
+
+  /**
+   * @param headers the headers of inputFiles, from MTReader.readBinaryHeaders
+   */
+  public NumericTable[] createDenseNumericTableSplitBinary(List<String> inputFiles, List<HarpBinaryFormat> headers, int nFeature1, int nFeature2, DaalContext context) throws IOException {//{{{
+
+    int nFeatures = nFeature1 + nFeature2;
+    MTReader reader = new MTReader();
+    List<BinaryRowRange> ranges = reader.splitDenseBinary(inputFiles, headers, nFeatures, MTReader.getBinaryRangeRows(nFeatures));
+
+    NumericTable[] inputTable = new NumericTable[2];
+    inputTable[0] = new HomogenNumericTable(context, Double.class, nFeature1, reader.getTotalLines(), NumericTable.AllocationFlag.DoAllocate);
+    inputTable[1] = new HomogenNumericTable(context, Double.class, nFeature2, reader.getTotalLines(), NumericTable.AllocationFlag.DoAllocate);
+
+    MergedNumericTable mergedTable = new MergedNumericTable(context);
+    mergedTable.addNumericTable(inputTable[0]);
+    mergedTable.addNumericTable(inputTable[1]);
+
+    if (!reader.readDenseBinary(ranges, nFeatures, mergedTable, this.conf, this.harpthreads))
+      throw new IOException("Fail to load dense binary files");
+
+    return inputTable;
+  }//}}}
+
+  private List<HarpBinaryFormat> readHeaders(List<String> inputFiles) throws IOException {//{{{
+    List<HarpBinaryFormat> headers = MTReader.readBinaryHeaders(inputFiles, this.conf);
+    if (headers == null)
+      throw new IOException("Not all the input files are in the Harp binary format");
+    return headers;
+  }//}}}
+
+  private List<String> listInputFiles(String inputFile) throws IOException {//{{{
+
+    Path inputFilePaths = new Path(inputFile);
+    List<String> inputFileList = new LinkedList<>();
+    FileSystem fs =
+        inputFilePaths.getFileSystem(conf);
+    RemoteIterator<LocatedFileStatus> iterator =
+        fs.listFiles(inputFilePaths, true);
+
+    while (iterator.hasNext()) {
+      String name =
+          iterator.next().getPath().toUri()
+              .toString();
+      inputFileList.add(name);
+    }
+
+    return inputFileList;
+  }//}}}
+
   // ------------------------------  Sparse COO files I/O ------------------------------
 
   public List<COO> loadCOOFiles(List<String> FilePaths, String regex) {//{{{
@@ -581,6 +688,10 @@ public class HarpDAALDataSource {
     LOG.info("read in file name: " + filename);
     Path file_path = new Path(filename);
 
+    HarpBinaryFormat header = HarpBinaryFormat.readHeader(file_path, conf);
+    if (header != null)
+      return loadCSRBinary(filename, header, context)[0];
+
     FSDataInputStream in = null;
     try {
 
@@ -653,6 +764,14 @@ public class HarpDAALDataSource {
     LOG.info("read in file name: " + filename);
     Path file_path = new Path(filename);
 
+    HarpBinaryFormat header = HarpBinaryFormat.readHeader(file_path, conf);
+    if (header != null) {
+      if (!header.hasLabels())
+        throw new IOException("No labels in " + filename);
+
+      return loadCSRBinary(filename, header, context);
+    }
+
     FSDataInputStream in = null;
     try {
 
@@ -742,6 +861,48 @@ public class HarpDAALDataSource {
 
   }//}}}
 
+  /**
+   * @brief load a CSR binary file, the second table holds the labels if
+   * the file has them
+   */
+  private NumericTable[] loadCSRBinary(String filename, HarpBinaryFormat header, DaalContext context) throws IOException {//{{{
+
+    HarpBinaryReader.checkLayout(filename, header, HarpBinaryFormat.CSR);
+    if (header.getNumNonZeros() > Integer.MAX_VALUE || header.getNumRows() >= Integer.MAX_VALUE)
+      throw new IOException("Too many entries in " + filename);
+
+    int nVectors = (int) header.getNumRows();
+    int nNonZeros = (int) header.getNumNonZeros();
+    long[] rowOffsets = new long[nVectors + 1];
+    long[] colIndices = new long[nNonZeros];
+    double[] data = new double[nNonZeros];
+    double[] labelData = header.hasLabels() ? new double[nVectors] : null;
+
+    HarpBinaryReader reader = new HarpBinaryReader(new Path(filename), this.conf);
+    try {
+      reader.readLongs(header.getRowIndexOffset(), rowOffsets, 0, nVectors + 1);
+      reader.readLongs(header.getColIndexOffset(), colIndices, 0, nNonZeros);
+      reader.readDoubles(header.getValueOffset(), data, 0, nNonZeros);
+      if (labelData != null)
+        reader.readDoubles(header.getLabelOffset(), labelData, 0, nVectors);
+    } finally {
+      reader.close();
+    }
+
+    if (nNonZeros != (rowOffsets[nVectors] - 1) || header.getNumCols() == 0 || nVectors == 0) {
+      throw new IOException("Unable to read input dataset");
+    }
+
+    NumericTable[] output = new NumericTable[2];
+    output[0] = new CSRNumericTable(context, data, colIndices, rowOffsets, header.getNumCols(), nVectors);
+    if (labelData != null) {
+      output[1] = new HomogenNumericTable(context, Double.class, 1, labelData.length, NumericTable.AllocationFlag.DoAllocate);
+      output[1].releaseBlockOfRows(0, labelData.length, DoubleBuffer.wrap(labelData));
+    }
+
+    return output;
+  }//}}}
+
   private int getRowLength(String line, String sep) {//{{{
     String[] elements = line.split(sep);
     return elements.length;
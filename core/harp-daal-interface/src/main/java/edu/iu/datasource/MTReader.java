@@ -23,6 +23,7 @@ import java.io.File;
 import java.io.FileWriter;
 import java.io.IOException;
 import java.io.OutputStreamWriter;
+import java.util.ArrayList;
 import java.util.LinkedList;
 import java.util.List;
 import java.util.Random;
@@ -40,7 +41,10 @@ import org.apache.hadoop.fs.FSDataOutputStream;
 import org.apache.hadoop.fs.FileSystem;
 import org.apache.hadoop.fs.Path;
 
+import com.intel.daal.data_management.data.NumericTable;
+
 import edu.iu.harp.schdynamic.DynamicScheduler;
+import edu.iu.harp.schdynamic.WorkStealingScheduler;
 import edu.iu.harp.partition.Partition;
 import edu.iu.harp.partition.Table;
 import edu.iu.harp.resource.DoubleArray;
@@ -50,6 +54,9 @@ public class MTReader {
   protected static final Log LOG = LogFactory
       .getLog(MTReader.class);
 
+  // the number of values read by a task at a time from binary files
+  private static final int BINARY_RANGE_VALUES = 1 << 20;
+
   private int totalLine;
   private int totalPoints;
   private String sep = ",";
@@ -284,6 +291,154 @@ public class MTReader {
 
   }//}}}
 
+  /**
+   * @param fileNames filenames in HDFS
+   * @param conf
+   * @return true if all the files are in the Harp binary format. Mixed
+   * files go to the text readers, which read binary files one by one.
+   */
+  public static boolean isBinaryInput(List<String> fileNames, Configuration conf) {//{{{
+    return readBinaryHeaders(fileNames, conf) != null;
+  }//}}}
+
+  /**
+   * @param fileNames filenames in HDFS
+   * @param conf
+   * @return the headers in the order of the files, or null if any file is
+   * not in the Harp binary format. The headers are passed on to
+   * splitDenseBinary, so each header is read once.
+   */
+  public static List<HarpBinaryFormat> readBinaryHeaders(List<String> fileNames, Configuration conf) {//{{{
+    if (fileNames.isEmpty())
+      return null;
+
+    List<HarpBinaryFormat> headers = new ArrayList<>(fileNames.size());
+    for (String fileName : fileNames) {
+      HarpBinaryFormat header = null;
+      try {
+        header = HarpBinaryFormat.readHeader(new Path(fileName), conf);
+      } catch (IOException e) {
+        LOG.warn("Fail to read the header of " + fileName, e);
+      }
+
+      if (header == null)
+        return null;
+
+      headers.add(header);
+    }
+
+    return headers;
+  }//}}}
+
+  /**
+   * @param fileNames    dense binary files in HDFS
+   * @param dim
+   * @param rowsPerRange the max number of rows per range
+   * @param conf
+   * @return the row ranges, in the order of the files
+   * @brief split dense binary files into row ranges, which are byte ranges
+   * of fixed width rows, and place them one after another in the table
+   */
+  public List<BinaryRowRange> splitDenseBinary(
+      List<String> fileNames, int dim, int rowsPerRange,
+      Configuration conf) throws IOException {//{{{
+
+    List<HarpBinaryFormat> headers = new ArrayList<>(fileNames.size());
+    for (String fileName : fileNames) {
+      HarpBinaryFormat header = HarpBinaryFormat.readHeader(new Path(fileName), conf);
+      if (header == null)
+        throw new IOException(fileName + " is not a Harp binary file");
+
+      headers.add(header);
+    }
+
+    return splitDenseBinary(fileNames, headers, dim, rowsPerRange);
+  }//}}}
+
+  /**
+   * @param fileNames    dense binary files in HDFS
+   * @param headers      the headers of the files, from readBinaryHeaders
+   * @param dim
+   * @param rowsPerRange the max number of rows per range
+   * @return the row ranges, in the order of the files
+   */
+  public List<BinaryRowRange> splitDenseBinary(
+      List<String> fileNames, List<HarpBinaryFormat> headers, int dim,
+      int rowsPerRange) throws IOException {//{{{
+
+    List<BinaryRowRange> ranges = new LinkedList<>();
+    long tableRow = 0;
+    for (int i = 0; i < fileNames.size(); i++) {
+      String fileName = fileNames.get(i);
+      HarpBinaryFormat header = headers.get(i);
+
+      HarpBinaryReader.checkLayout(fileName, header, HarpBinaryFormat.DENSE);
+      if (header.getNumCols() != dim)
+        throw new IOException("Expect " + dim + " values per row, but "
+            + fileName + " has " + header.getNumCols());
+
+      long nRows = header.getNumRows();
+      for (long row = 0; row < nRows; row += rowsPerRange) {
+        int numRows = (int) Math.min(rowsPerRange, nRows - row);
+        ranges.add(new BinaryRowRange(fileName, header, row, numRows, tableRow + row));
+      }
+      tableRow += nRows;
+    }
+
+    // the tables are created with int row counts
+    if (tableRow > Integer.MAX_VALUE)
+      throw new IOException("Too many rows in the binary files: " + tableRow);
+
+    this.totalLine = (int) tableRow;
+    this.totalPoints = (int) Math.min(tableRow * dim, Integer.MAX_VALUE);
+    return ranges;
+  }//}}}
+
+  /**
+   * @param ranges     the row ranges of dense binary files
+   * @param dim
+   * @param table      the table to fill, with getTotalLines() rows
+   * @param conf
+   * @param numThreads
+   * @return true if all the rows are loaded
+   * @brief fill a NumericTable from dense binary files, the ranges given by
+   * splitDenseBinary are read in parallel
+   */
+  public boolean readDenseBinary(
+      List<BinaryRowRange> ranges, int dim, NumericTable table,
+      Configuration conf, int numThreads) {//{{{
+
+    List<ReadDenseBinaryTask> tasks = new LinkedList<>();
+    for (int i = 0; i < numThreads; i++) {
+      tasks.add(new ReadDenseBinaryTask(dim, table, conf));
+    }
+
+    WorkStealingScheduler<BinaryRowRange, double[][], ReadDenseBinaryTask> compute =
+        new WorkStealingScheduler<>(tasks);
+
+    compute.submitAll(ranges);
+    compute.start();
+    compute.stop();
+
+    while (compute.hasOutput()) {
+      compute.waitForOutput();
+    }
+
+    for (ReadDenseBinaryTask task : tasks) {
+      task.close();
+    }
+
+    return !compute.hasError();
+  } //}}}
+
+  /**
+   * @param dim
+   * @return the number of rows per range for dense binary files
+   */
+  public static int getBinaryRangeRows(int dim) {//{{{
+    return Math.max(1, BINARY_RANGE_VALUES / dim);
+  }//}}}
+
   public int getTotalLines() {
     return this.totalLine;
   }
@@ -87,6 +87,12 @@ public class ReadCOOTask implements
     List<COO> points = new LinkedList<COO>();
 
     Path pointFilePath = new Path(file);
+    HarpBinaryFormat header = HarpBinaryFormat.readHeader(pointFilePath, conf);
+    if (header != null) {
+      // binary input, no parsing
+      return HarpBinaryReader.readCOO(file, header, conf);
+    }
+
     FileSystem fs = pointFilePath.getFileSystem(conf);
     FSDataInputStream in = fs.open(pointFilePath);
 
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2013-2018 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.datasource;
+
+import java.io.IOException;
+import java.nio.DoubleBuffer;
+
+import org.apache.commons.logging.Log;
+import org.apache.commons.logging.LogFactory;
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.fs.Path;
+
+import com.intel.daal.data_management.data.NumericTable;
+
+import edu.iu.harp.schdynamic.Task;
+
+/**
+ * @brief read row ranges of dense Harp binary files, either into a DAAL
+ * NumericTable or into double[][] shards. The task reuses one row buffer,
+ * so nothing is allocated per row when filling a NumericTable. The file of
+ * the last range is kept open, ranges are submitted in file order.
+ */
+public class ReadDenseBinaryTask implements
+    Task<BinaryRowRange, double[][]> {
+
+  protected static final Log LOG = LogFactory
+      .getLog(ReadDenseBinaryTask.class);
+
+  private int valperline;
+  private Configuration conf;
+  private NumericTable table;
+  private double[] buffer;
+  private String readerFileName;
+  private HarpBinaryReader reader;
+
+  /**
+   * @param valperline the number of values per row
+   * @param table      the destination table, null to return shards
+   * @param conf
+   */
+  public ReadDenseBinaryTask(int valperline, NumericTable table, Configuration conf) {
+    this.valperline = valperline;
+    this.table = table;
+    this.conf = conf;
+    this.buffer = new double[0];
+  }
+
+  /**
+   * @param range the row range
+   * @return the rows as a shard, or null when filling a NumericTable
+   * @brief Java thread kernel
+   */
+  @Override
+  public double[][] run(BinaryRowRange range)
+      throws Exception {
+
+    int numRows = range.getNumRows();
+    int numVals = numRows * valperline;
+    if (this.buffer.length < numVals)
+      this.buffer = new double[numVals];
+
+    if (!range.getFileName().equals(this.readerFileName)) {
+      close();
+      this.reader = new HarpBinaryReader(new Path(range.getFileName()), this.conf);
+      this.readerFileName = range.getFileName();
+    }
+
+    this.reader.readDoubles(range.getByteOffset(), this.buffer, 0, numVals);
+
+    if (this.table != null) {
+      // DAAL copies the block into its own memory. The ranges cover
+      // disjoint rows, so the tasks write the table without a lock.
+      this.table.releaseBlockOfRows(range.getTableRow(), numRows,
+          DoubleBuffer.wrap(this.buffer, 0, numVals));
+      return null;
+    }
+
+    double[][] shard = new double[numRows][];
+    for (int j = 0; j < numRows; j++) {
+      shard[j] = new double[valperline];
+      System.arraycopy(this.buffer, j * valperline, shard[j], 0, valperline);
+    }
+
+    return shard;
+  }
+
+  /**
+   * @brief close the file of the last range
+   */
+  public void close() {
+    if (this.reader != null) {
+      try {
+        this.reader.close();
+      } catch (IOException e) {
+        LOG.warn("Fail to close " + this.readerFileName, e);
+      }
+    }
+
+    this.reader = null;
+    this.readerFileName = null;
+  }
+
+}
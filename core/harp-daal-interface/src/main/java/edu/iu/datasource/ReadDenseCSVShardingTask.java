@@ -99,6 +99,12 @@ public class ReadDenseCSVShardingTask implements
     List<double[][]> outputlist = new LinkedList<double[][]>();
 
     Path pointFilePath = new Path(file);
+    HarpBinaryFormat header = HarpBinaryFormat.readHeader(pointFilePath, conf);
+    if (header != null) {
+      // binary input, no parsing
+      return HarpBinaryReader.readDenseShards(file, header, valperline, shardsize, conf);
+    }
+
     FileSystem fs =
         pointFilePath.getFileSystem(conf);
     FSDataInputStream in = fs.open(pointFilePath);
@@ -92,6 +92,12 @@ public class ReadDenseCSVTask implements
     List<double[]> points = new LinkedList<double[]>();
 
     Path pointFilePath = new Path(file);
+    HarpBinaryFormat header = HarpBinaryFormat.readHeader(pointFilePath, conf);
+    if (header != null) {
+      // binary input, no parsing
+      return HarpBinaryReader.readDenseRows(file, header, valperline, conf);
+    }
+
     FileSystem fs =
         pointFilePath.getFileSystem(conf);
     FSDataInputStream in = fs.open(pointFilePath);
@@ -0,0 +1,229 @@
+package edu.iu.datasource;
+
+import org.apache.hadoop.conf.Configuration;
+import org.apache.hadoop.fs.FileUtil;
+import org.apache.hadoop.fs.Path;
+import org.junit.After;
+import org.junit.Assert;
+import org.junit.Before;
+import org.junit.Test;
+
+import java.io.File;
+import java.io.FileWriter;
+import java.io.IOException;
+import java.io.Writer;
+import java.nio.file.Files;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+
+public class HarpBinaryFormatTest {
+
+  // splits every value across two buffers
+  private static final int SMALL_READ_SIZE = 12;
+
+  private Configuration conf;
+  private File dir;
+
+  @Before
+  public void setUp() throws IOException {
+    conf = new Configuration();
+    dir = Files.createTempDirectory("harp-binary").toFile();
+  }
+
+  @After
+  public void tearDown() {
+    FileUtil.fullyDelete(dir);
+  }
+
+  @Test
+  public void testDenseRoundTrip() throws IOException {
+    double[][] rows = createRows(5, 3, 0);
+    String file = writeDense("dense", rows);
+    HarpBinaryFormat header =
+        HarpBinaryFormat.readHeader(new Path(file), conf);
+    Assert.assertEquals(HarpBinaryFormat.DENSE, header.getLayout());
+    Assert.assertEquals(5L, header.getNumRows());
+    Assert.assertEquals(3L, header.getNumCols());
+    Assert.assertEquals(header.getFileLength(),
+        new File(dir, "dense.bin").length());
+    List<double[]> points =
+        HarpBinaryReader.readDenseRows(file, header, 3, conf);
+    Assert.assertEquals(rows.length, points.size());
+    for (int i = 0; i < rows.length; i++) {
+      Assert.assertArrayEquals(rows[i], points.get(i), 0.0);
+    }
+  }
+
+  @Test
+  public void testCarryOver() throws IOException {
+    double[][] rows = createRows(4, 3, 0);
+    String file = writeDense("dense", rows);
+    HarpBinaryFormat header =
+        HarpBinaryFormat.readHeader(new Path(file), conf);
+    double[] dst = new double[9];
+    HarpBinaryReader reader = new HarpBinaryReader(new Path(file), conf,
+        SMALL_READ_SIZE);
+    try {
+      reader.readDoubles(header.getRowOffset(1), dst, 0, 9);
+    } finally {
+      reader.close();
+    }
+    for (int i = 0; i < 3; i++) {
+      Assert.assertArrayEquals(rows[i + 1],
+          Arrays.copyOfRange(dst, i * 3, i * 3 + 3), 0.0);
+    }
+  }
+
+  @Test
+  public void testSplitDenseBinary() throws IOException {
+    double[][] rows1 = createRows(5, 3, 0);
+    double[][] rows2 = createRows(3, 3, 5);
+    String file1 = writeDense("dense-1", rows1);
+    String file2 = writeDense("dense-2", rows2);
+    MTReader mtReader = new MTReader();
+    List<BinaryRowRange> ranges = mtReader.splitDenseBinary(
+        Arrays.asList(file1, file2), 3, 2, conf);
+    Assert.assertEquals(8, mtReader.getTotalLines());
+    Assert.assertEquals(5, ranges.size());
+    long[] tableRows = {0L, 2L, 4L, 5L, 7L};
+    int[] numRows = {2, 2, 1, 2, 1};
+    // Fill a flat table from the ranges, as ReadDenseBinaryTask does
+    double[] table = new double[8 * 3];
+    for (int i = 0; i < ranges.size(); i++) {
+      BinaryRowRange range = ranges.get(i);
+      Assert.assertEquals(tableRows[i], range.getTableRow());
+      Assert.assertEquals(numRows[i], range.getNumRows());
+      HarpBinaryReader reader = new HarpBinaryReader(
+          new Path(range.getFileName()), conf, SMALL_READ_SIZE);
+      try {
+        reader.readDoubles(range.getByteOffset(), table,
+            (int) range.getTableRow() * 3, range.getNumRows() * 3);
+      } finally {
+        reader.close();
+      }
+    }
+    for (int i = 0; i < 8; i++) {
+      double[] row = i < 5 ? rows1[i] : rows2[i - 5];
+      Assert.assertArrayEquals(row,
+          Arrays.copyOfRange(table, i * 3, i * 3 + 3), 0.0);
+    }
+  }
+
+  @Test
+  public void testCSRRoundTrip() throws IOException {
+    String input = writeText("csr.txt",
+        "1,3,4,6\n1,3,2,1,4\n0.5,1.5,2.5,3.5,4.5\n1\n0\n1\n");
+    String file = new File(dir, "csr.bin").toURI().toString();
+    HarpBinaryWriter.convertCSR(input, file, ",", conf);
+    HarpBinaryFormat header =
+        HarpBinaryFormat.readHeader(new Path(file), conf);
+    Assert.assertEquals(HarpBinaryFormat.CSR, header.getLayout());
+    Assert.assertEquals(3L, header.getNumRows());
+    Assert.assertEquals(4L, header.getNumCols());
+    Assert.assertEquals(5L, header.getNumNonZeros());
+    Assert.assertTrue(header.hasLabels());
+    Assert.assertEquals(header.getFileLength(),
+        new File(dir, "csr.bin").length());
+    long[] rowOffsets = new long[4];
+    long[] colIndices = new long[5];
+    double[] values = new double[5];
+    double[] labels = new double[3];
+    HarpBinaryReader reader = new HarpBinaryReader(new Path(file), conf,
+        SMALL_READ_SIZE);
+    try {
+      reader.readLongs(header.getRowIndexOffset(), rowOffsets, 0, 4);
+      reader.readLongs(header.getColIndexOffset(), colIndices, 0, 5);
+      reader.readDoubles(header.getValueOffset(), values, 0, 5);
+      reader.readDoubles(header.getLabelOffset(), labels, 0, 3);
+    } finally {
+      reader.close();
+    }
+    Assert.assertArrayEquals(new long[] {1L, 3L, 4L, 6L}, rowOffsets);
+    Assert.assertArrayEquals(new long[] {1L, 3L, 2L, 1L, 4L}, colIndices);
+    Assert.assertArrayEquals(new double[] {0.5, 1.5, 2.5, 3.5, 4.5},
+        values, 0.0);
+    Assert.assertArrayEquals(new double[] {1.0, 0.0, 1.0}, labels, 0.0);
+  }
+
+  @Test
+  public void testCOORoundTrip() throws IOException {
+    String input = writeText("coo.txt", "1 2 0.5\n3 1 1.5\n2 4 2.5\n");
+    String file = new File(dir, "coo.bin").toURI().toString();
+    HarpBinaryWriter.convertCOO(input, file, " ", conf);
+    HarpBinaryFormat header =
+        HarpBinaryFormat.readHeader(new Path(file), conf);
+    List<COO> points = HarpBinaryReader.readCOO(file, header, conf);
+    Assert.assertEquals(3, points.size());
+    Assert.assertEquals(3L, points.get(1).getRowId());
+    Assert.assertEquals(1L, points.get(1).getColId());
+    Assert.assertEquals(2.5, points.get(2).getVal(), 0.0);
+  }
+
+  @Test
+  public void testMixedInput() throws IOException {
+    String binary1 = writeDense("dense-1", createRows(2, 3, 0));
+    String binary2 = writeDense("dense-2", createRows(2, 3, 2));
+    String text = writeText("dense.txt", "1,2,3\n4,5,6\n");
+    Assert.assertTrue(MTReader.isBinaryInput(
+        Arrays.asList(binary1, binary2), conf));
+    Assert.assertFalse(MTReader.isBinaryInput(
+        Arrays.asList(binary1, text), conf));
+    Assert.assertFalse(MTReader.isBinaryInput(
+        Arrays.asList(text, binary1), conf));
+    Assert.assertFalse(MTReader.isBinaryInput(
+        Collections.<String>emptyList(), conf));
+  }
+
+  @Test
+  public void testConverterOutputFile() {
+    Assert.assertEquals("/out/a/part-0",
+        HarpBinaryConverter.getOutputFile("hdfs://nn:9000/in",
+            "hdfs://nn:9000/in/a/part-0", "/out"));
+    Assert.assertEquals("/out/b/part-0",
+        HarpBinaryConverter.getOutputFile("hdfs://nn:9000/in",
+            "hdfs://nn:9000/in/b/part-0", "/out"));
+    Assert.assertEquals("/out/part-0",
+        HarpBinaryConverter.getOutputFile("/in/part-0", "/in/part-0",
+            "/out"));
+    Assert.assertEquals("/out/in/a/part-0",
+        HarpBinaryConverter.getOutputFile("/in/*", "/in/a/part-0", "/out"));
+  }
+
+  private double[][] createRows(int nRows, int nCols, int firstRow) {
+    double[][] rows = new double[nRows][nCols];
+    for (int i = 0; i < nRows; i++) {
+      for (int j = 0; j < nCols; j++) {
+        rows[i][j] = (firstRow + i) + j * 0.25;
+      }
+    }
+    return rows;
+  }
+
+  private String writeDense(String name, double[][] rows)
+      throws IOException {
+    StringBuilder text = new StringBuilder();
+    for (double[] row : rows) {
+      for (int j = 0; j < row.length; j++) {
+        text.append(j == 0 ? "" : ",").append(row[j]);
+      }
+      text.append("\n");
+    }
+    String input = writeText(name + ".txt", text.toString());
+    String output = new File(dir, name + ".bin").toURI().toString();
+    HarpBinaryWriter.convertDenseCSV(input, output, rows[0].length, ",",
+        conf);
+    return output;
+  }
+
+  private String writeText(String name, String text) throws IOException {
+    File file = new File(dir, name);
+    Writer writer = new FileWriter(file);
+    try {
+      writer.write(text);
+    } finally {
+      writer.close();
+    }
+    return file.toURI().toString();
+  }
+}
@@ -22,35 +22,51 @@ import edu.iu.harp.client.SyncClient;
 import edu.iu.harp.collective.AllgatherCollective;
 import edu.iu.harp.collective.AllreduceCollective;
 import edu.iu.harp.collective.BcastCollective;
+import edu.iu.harp.collective.CollectiveRequest;
 import edu.iu.harp.collective.Communication;
 import edu.iu.harp.collective.LocalGlobalSyncCollective;
 import edu.iu.harp.collective.ReduceCollective;
 import edu.iu.harp.collective.RegroupCollective;
+import edu.iu.harp.example.LongArrPlus;
 import edu.iu.harp.io.ConnPool;
 import edu.iu.harp.io.Constant;
 import edu.iu.harp.io.DataMap;
 import edu.iu.harp.io.EventQueue;
+import edu.iu.harp.io.SharedSegment;
+import edu.iu.harp.io.Transport;
+import edu.iu.harp.metrics.CollectiveMetrics;
+import edu.iu.harp.partition.Partition;
 import edu.iu.harp.partition.Partitioner;
 import edu.iu.harp.partition.Table;
+import edu.iu.harp.resource.LongArray;
 import edu.iu.harp.resource.ResourcePool;
 import edu.iu.harp.resource.Simple;
+import edu.iu.harp.resource.Writable;
+import edu.iu.harp.resource.WritableRegistry;
 import edu.iu.harp.server.Server;
 import edu.iu.harp.worker.Workers;
 import it.unimi.dsi.fastutil.ints.Int2IntMap;
 import org.apache.commons.logging.Log;
 import org.apache.commons.logging.LogFactory;
 import org.apache.hadoop.fs.FSDataInputStream;
+import org.apache.hadoop.fs.FSDataOutputStream;
 import org.apache.hadoop.fs.FileSystem;
 import org.apache.hadoop.fs.Path;
 import org.apache.hadoop.mapreduce.Mapper;
 
 import java.io.BufferedReader;
+import java.io.File;
 import java.io.IOException;
 import java.io.InputStreamReader;
 import java.lang.management.GarbageCollectorMXBean;
 import java.lang.management.ManagementFactory;
+import java.util.Arrays;
+import java.util.List;
 import java.util.Map;
 import java.util.TreeMap;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
 import java.util.concurrent.ForkJoinPool;
 import java.util.concurrent.TimeUnit;
 
@@ -75,12 +91,84 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
   protected static final Log LOG =
     LogFactory.getLog(CollectiveMapper.class);
 
+  /**
+   * The allreduce algorithm: "doubling" for
+   * recursive halving/doubling, "ring" for the
+   * pipelined ring, "hierarchical" to reduce
+   * within each node first, "auto" to choose by
+   * the table size and the worker placement. With
+   * "auto", the workers vote on the ring
+   * algorithm with a small allreduce on the first
+   * operation of each context/operation name, so
+   * they always agree, and the decision is reused
+   * by the later operations with the same names.
+   */
+  public static final String ALLREDUCE_ALGORITHM =
+    "harp.allreduce.algorithm";
+  public static final String ALLREDUCE_DOUBLING =
+    "doubling";
+  public static final String ALLREDUCE_RING =
+    "ring";
+  public static final String ALLREDUCE_HIERARCHICAL =
+    "hierarchical";
+  public static final String ALLREDUCE_AUTO =
+    "auto";
+  /**
+   * If broadcast goes through the node leaders
+   * when several workers share a node
+   */
+  public static final String BCAST_HIERARCHICAL =
+    "harp.bcast.hierarchical";
+  /**
+   * If the workers on the same node exchange data
+   * in the hierarchical operations through shared
+   * segments under /dev/shm instead of the
+   * connections
+   */
+  public static final String SHARED_SEGMENT =
+    "harp.shared.segment";
+  /**
+   * The Writable classes encoded as class IDs,
+   * comma separated. IDs follow the order.
+   */
+  public static final String WRITABLE_CLASSES =
+    "harp.writable.classes";
+  /**
+   * If a partition list of Writables of the same
+   * class is encoded with the class written once
+   */
+  public static final String WRITABLE_BATCH =
+    "harp.writable.batch";
+  /**
+   * The directory of the Chrome trace files, one
+   * per worker. Tracing is off if not set.
+   */
+  public static final String TRACE_DIR =
+    "harp.trace.dir";
+  /**
+   * The number of threads running the
+   * non-blocking collectives. Operations started
+   * beyond it wait in the order they are started.
+   */
+  public static final String ASYNC_THREADS =
+    "harp.collective.async.threads";
+  /** The counter group of collective metrics */
+  public static final String METRICS_GROUP =
+    "Harp Collective";
+
   private int workerID;
+  private String allreduceAlgorithm;
+  private boolean useHierarchicalBcast;
   private Workers workers;
   private EventQueue eventQueue;
   private DataMap dataMap;
   private Server server;
   private SyncClient client;
+  /** Runs the non-blocking collectives */
+  private ExecutorService collectiveExecutor;
+  /** The ring votes of the "auto" allreduce */
+  private final Map<String, Boolean> ringDecisions =
+    new ConcurrentHashMap<>();
 
   /*******************************************************
    * A Key-Value reader to read key-value inputs
@@ -258,6 +346,52 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     String nodesFile = jobDir + "/nodes";
     String tasksFile = jobDir + "/tasks";
     String lockFile = jobDir + "/lock";
+    allreduceAlgorithm =
+      context.getConfiguration().get(
+        ALLREDUCE_ALGORITHM, ALLREDUCE_DOUBLING);
+    LOG.info(
+      "Allreduce algorithm " + allreduceAlgorithm);
+    useHierarchicalBcast = context
+      .getConfiguration()
+      .getBoolean(BCAST_HIERARCHICAL, false);
+    // The transport backend, "bio" or "nio"
+    Transport.set(Transport.parse(
+      context.getConfiguration()
+        .get(Transport.TRANSPORT),
+      Transport.get()));
+    LOG.info("Transport " + Transport.get());
+    // One segment directory per job, so the jobs
+    // sharing a node do not see each other's data
+    SharedSegment.setEnabled(context
+      .getConfiguration()
+      .getBoolean(SHARED_SEGMENT, true));
+    SharedSegment.setDir(new File(
+      SharedSegment.getDefaultDir(), jobDir));
+    LOG.info("Shared segments "
+      + SharedSegment.isEnabled() + " in "
+      + SharedSegment.getDir());
+    // Every worker registers the classes from the
+    // job configuration, then the registries are
+    // compared after the handshake before any
+    // Writable is sent
+    WritableRegistry.get().reset();
+    WritableRegistry.get().setUseBatch(
+      context.getConfiguration()
+        .getBoolean(WRITABLE_BATCH, true));
+    String[] writableClasses = context
+      .getConfiguration()
+      .getTrimmedStrings(WRITABLE_CLASSES);
+    if (!WritableRegistry.get()
+      .register(Arrays.asList(writableClasses))) {
+      throw new IOException(
+        "Cannot register Writable classes.");
+    }
+    LOG.info("Writable classes "
+      + WritableRegistry.get().getClassNames());
+    CollectiveMetrics.get().reset();
+    CollectiveMetrics.get().setTracing(
+      context.getConfiguration()
+        .get(TRACE_DIR) != null);
     FileSystem fs =
       FileSystem.get(context.getConfiguration());
     // Try lock
@@ -290,6 +424,10 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     eventQueue = new EventQueue();
     dataMap = new DataMap();
     client = new SyncClient(workers);
+    collectiveExecutor =
+      Executors.newFixedThreadPool(Math.max(1,
+        context.getConfiguration()
+          .getInt(ASYNC_THREADS, 2)));
     // Initialize receiver
     String host = workers.getSelfInfo().getNode();
     int port = workers.getSelfInfo().getPort();
@@ -307,6 +445,10 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     isSuccess =
       barrier("start-worker", "handshake");
     LOG.info("Barrier: " + isSuccess);
+    if (isSuccess) {
+      isSuccess = checkWritables("start-worker",
+        "writable-classes");
+    }
     return isSuccess;
   }
 
@@ -382,6 +524,112 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     return isSuccess;
   }
 
+  /**
+   * Register Writable classes so they are
+   * encoded as class IDs. All the workers must
+   * call it with the same classes in the same
+   * order. The registries are then compared on
+   * all the workers, so no worker sends an ID
+   * before others know it, and the operation
+   * fails everywhere if the IDs differ.
+   * 
+   * @param contextName
+   * @param operationName
+   * @param classes
+   *          the classes to register
+   * @return false if the operation fails or the
+   *         registries differ
+   */
+  public boolean registerWritables(
+    String contextName, String operationName,
+    List<Class<? extends Writable>> classes) {
+    for (Class<? extends Writable> clazz : classes) {
+      WritableRegistry.get().register(clazz);
+    }
+    return checkWritables(contextName,
+      operationName);
+  }
+
+  /**
+   * Count the workers preferring the ring
+   * algorithm for the allreduce on their tables.
+   * Each worker only knows its own table, so the
+   * votes are summed on all the workers.
+   * 
+   * @param contextName
+   *          the name of the operation context
+   * @param operationName
+   *          the name of the operation
+   * @param table
+   *          the table to allreduce
+   * @param ringWorkers
+   *          the workers in the ring
+   * @return the number of votes, -1 if failed
+   */
+  private <P extends Simple> int voteForRing(
+    String contextName, String operationName,
+    Table<P> table, Workers ringWorkers) {
+    Table<LongArray> voteTable =
+      new Table<>(0, new LongArrPlus());
+    LongArray voteArray = LongArray.create(1, false);
+    voteArray.get()[0] = AllreduceCollective
+      .isRingPreferred(table, ringWorkers) ? 1L : 0L;
+    voteTable
+      .addPartition(new Partition<>(0, voteArray));
+    int numVotes = -1;
+    if (allreduce(contextName,
+      operationName + "-ring-vote", voteTable,
+      false)) {
+      numVotes = (int) voteTable.getPartition(0)
+        .get().get()[0];
+    }
+    voteTable.release();
+    return numVotes;
+  }
+
+  /**
+   * Allgather the hash of the registered class
+   * names in ID order and compare it with the
+   * hashes of all the workers. Every worker sees
+   * the same hashes, so all of them agree on the
+   * result.
+   * 
+   * @param contextName
+   * @param operationName
+   * @return false if the operation fails or the
+   *         registries differ
+   */
+  private boolean checkWritables(
+    String contextName, String operationName) {
+    long classHash =
+      WritableRegistry.get().getClassHash();
+    Table<LongArray> hashTable =
+      new Table<>(0, new LongArrPlus());
+    LongArray hashArray = LongArray.create(1, false);
+    hashArray.get()[0] = classHash;
+    hashTable
+      .addPartition(new Partition<>(workerID, hashArray));
+    if (!allgather(contextName, operationName,
+      hashTable)) {
+      hashTable.release();
+      return false;
+    }
+    boolean isSame = true;
+    for (Partition<LongArray> partition : hashTable
+      .getPartitions()) {
+      if (partition.get().get()[0] != classHash) {
+        LOG.error("Writable classes on worker "
+          + partition.id()
+          + " differ from the classes on worker "
+          + workerID + ": "
+          + WritableRegistry.get().getClassNames());
+        isSame = false;
+      }
+    }
+    hashTable.release();
+    return isSame;
+  }
+
   /**
    * Broadcast the partitions of the table on a
    * worker to other workers.
@@ -405,10 +653,19 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     String contextName, String operationName,
     Table<P> table, int bcastWorkerID,
     boolean useMSTBcast) {
-    boolean isSucess =
-      BcastCollective.broadcast(contextName,
-        operationName, table, bcastWorkerID,
-        useMSTBcast, dataMap, workers);
+    boolean isSucess = false;
+    if (useHierarchicalBcast && workers
+      .getNumNodes() < workers.getNumWorkers()) {
+      isSucess = BcastCollective
+        .hierarchicalBroadcast(contextName,
+          operationName, table, bcastWorkerID,
+          dataMap, workers);
+    } else {
+      isSucess = BcastCollective.broadcast(
+        contextName, operationName, table,
+        bcastWorkerID, useMSTBcast, dataMap,
+        workers);
+    }
     dataMap.cleanOperationData(contextName,
       operationName);
     return isSucess;
@@ -480,9 +737,79 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
   public <P extends Simple> boolean allreduce(
     String contextName, String operationName,
     Table<P> table) {
-    boolean isSuccess =
-      AllreduceCollective.allreduce(contextName,
-        operationName, table, dataMap, workers);
+    boolean useRing = false;
+    boolean useHierarchy = false;
+    if (allreduceAlgorithm
+      .equals(ALLREDUCE_RING)) {
+      useRing = true;
+    } else if (allreduceAlgorithm
+      .equals(ALLREDUCE_HIERARCHICAL)) {
+      useHierarchy = true;
+    } else if (allreduceAlgorithm
+      .equals(ALLREDUCE_AUTO)) {
+      // The placement is the same on all the
+      // workers, the table size is not
+      useHierarchy = workers
+        .getNumNodes() < workers.getNumWorkers();
+      String key = CollectiveMetrics
+        .getKey(contextName, operationName);
+      Boolean decision = ringDecisions.get(key);
+      if (decision == null) {
+        int numVotes = voteForRing(contextName,
+          operationName, table, useHierarchy
+            ? workers.getNodeLeaders() : workers);
+        if (numVotes < 0) {
+          return false;
+        }
+        decision =
+          numVotes == workers.getNumWorkers();
+        ringDecisions.put(key, decision);
+      }
+      useRing = decision;
+    }
+    if (!useHierarchy) {
+      return allreduce(contextName, operationName,
+        table, useRing);
+    }
+    boolean isSuccess = AllreduceCollective
+      .hierarchicalAllreduce(contextName,
+        operationName, table, useRing, dataMap,
+        workers);
+    dataMap.cleanOperationData(contextName,
+      operationName);
+    return isSuccess;
+  }
+
+  /**
+   * Allreduce partitions of the tables to all the
+   * local tables with the given algorithm.
+   * 
+   * @param contextName
+   *          the name of the operation context
+   * @param operationName
+   *          the name of the operation
+   * @param table
+   *          the table to hold the partitions
+   * @param useRing
+   *          if the pipelined ring algorithm is
+   *          used, otherwise recursive
+   *          halving/doubling is used
+   * @return a boolean tells if the operation
+   *         succeeds
+   */
+  public <P extends Simple> boolean allreduce(
+    String contextName, String operationName,
+    Table<P> table, boolean useRing) {
+    boolean isSuccess = false;
+    if (useRing) {
+      isSuccess = AllreduceCollective
+        .ringAllreduce(contextName, operationName,
+          table, dataMap, workers);
+    } else {
+      isSuccess =
+        AllreduceCollective.allreduce(contextName,
+          operationName, table, dataMap, workers);
+    }
     dataMap.cleanOperationData(contextName,
       operationName);
     return isSuccess;
@@ -615,6 +942,111 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     return isSuccess;
   }
 
+  /**
+   * Start broadcasting the partitions of the
+   * table without blocking. The table must not
+   * be accessed until the operation completes.
+   * 
+   * @param contextName
+   *          the name of the operation context
+   * @param operationName
+   *          the name of the operation
+   * @param table
+   *          the table used to hold the
+   *          partitions
+   * @param bcastWorkerID
+   *          the worker ID of broadcasting data
+   * @param useMSTBcast
+   *          if minimum-spanning tree algorithm
+   *          is used
+   * @return the handle of the operation
+   */
+  public <P extends Simple> CollectiveRequest
+    ibcast(String contextName,
+      String operationName, Table<P> table,
+      int bcastWorkerID, boolean useMSTBcast) {
+    return CollectiveRequest.start(contextName,
+      operationName,
+      () -> broadcast(contextName, operationName,
+        table, bcastWorkerID, useMSTBcast),
+      collectiveExecutor);
+  }
+
+  /**
+   * Start allgathering the partitions of the
+   * tables without blocking. The table must not
+   * be accessed until the operation completes.
+   * 
+   * @param contextName
+   *          the name of the operation context
+   * @param operationName
+   *          the name of the operation
+   * @param table
+   *          the table to hold the partitions
+   * @return the handle of the operation
+   */
+  public <P extends Simple> CollectiveRequest
+    iallgather(String contextName,
+      String operationName, Table<P> table) {
+    return CollectiveRequest.start(contextName,
+      operationName,
+      () -> allgather(contextName, operationName,
+        table),
+      collectiveExecutor);
+  }
+
+  /**
+   * Start allreducing the partitions of the
+   * tables without blocking. The table must not
+   * be accessed until the operation completes.
+   * 
+   * @param contextName
+   *          the name of the operation context
+   * @param operationName
+   *          the name of the operation
+   * @param table
+   *          the table to hold the partitions
+   * @return the handle of the operation
+   */
+  public <P extends Simple> CollectiveRequest
+    iallreduce(String contextName,
+      String operationName, Table<P> table) {
+    return CollectiveRequest.start(contextName,
+      operationName,
+      () -> allreduce(contextName, operationName,
+        table),
+      collectiveExecutor);
+  }
+
+  /**
+   * Start rotating the partitions of the global
+   * table without blocking. The table must not
+   * be accessed until the operation completes.
+   * 
+   * @param contextName
+   *          the name of the operation context
+   * @param operationName
+   *          the name of operation
+   * @param globalTable
+   *          the global table which acts like a
+   *          distributed dataset, each partition
+   *          in this table is unique
+   * @param rotateMap
+   *          the map from worker to worker,
+   *          defines how to rotate the data
+   * @return the handle of the operation
+   */
+  public <P extends Simple> CollectiveRequest
+    irotate(String contextName,
+      String operationName, Table<P> globalTable,
+      Int2IntMap rotateMap) {
+    return CollectiveRequest.start(contextName,
+      operationName,
+      () -> rotate(contextName, operationName,
+        globalTable, rotateMap),
+      collectiveExecutor);
+  }
+
   /**
    * Get an event from the event queue.
    * 
@@ -741,6 +1173,98 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
     // NOTHING
   }
 
+  /**
+   * Report the collective metrics as counters.
+   * Hadoop merges the counter names of all the
+   * mappers, so only fixed names are used: the
+   * totals of each type, the array pools and the
+   * worker waited for the longest. The metrics
+   * of each operation and each worker are in the
+   * log and the trace. If the trace directory is
+   * set, write the trace of this worker there.
+   * 
+   * @param context
+   *          the context
+   */
+  private void reportMetrics(Context context) {
+    CollectiveMetrics metrics =
+      CollectiveMetrics.get();
+    try {
+      metrics.log();
+      for (int i =
+        0; i < CollectiveMetrics.NUM_TYPES; i++) {
+        String name =
+          CollectiveMetrics.TYPE_NAMES[i];
+        context.getCounter(METRICS_GROUP,
+          "Total " + name + " (ns)")
+          .increment(metrics.getTotalNanos(i));
+        context.getCounter(METRICS_GROUP,
+          "Total " + name + " (bytes)")
+          .increment(metrics.getTotalBytes(i));
+      }
+      ResourcePool pool = ResourcePool.get();
+      context.getCounter(METRICS_GROUP,
+        "Array pool hits")
+        .increment(pool.getNumArrayHits());
+      context.getCounter(METRICS_GROUP,
+        "Array pool misses")
+        .increment(pool.getNumArrayMisses());
+      context.getCounter(METRICS_GROUP,
+        "Array pool retained (bytes)")
+        .increment(pool.getNumRetainedBytes());
+      // Counters are summed over the tasks, so the
+      // stragglers are only logged and traced, the
+      // waits are in "Total wait (ns)"
+      Map<Integer, Long> stragglers = metrics
+        .getStragglers(
+          CollectiveMetrics.NUM_STRAGGLERS);
+      for (Map.Entry<Integer, Long> entry : stragglers
+        .entrySet()) {
+        LOG.info("Straggler worker "
+          + entry.getKey() + " wait (ns): "
+          + entry.getValue());
+      }
+      String traceDir = context
+        .getConfiguration().get(TRACE_DIR);
+      if (traceDir != null) {
+        Path tracePath = new Path(traceDir,
+          "worker-" + workerID + ".json");
+        FileSystem fs = tracePath.getFileSystem(
+          context.getConfiguration());
+        FSDataOutputStream out =
+          fs.create(tracePath, true);
+        metrics.writeTrace(out, workerID);
+        LOG.info("Write the trace to " + tracePath);
+      }
+    } catch (Exception e) {
+      LOG.error("Fail to report the metrics.", e);
+    }
+  }
+
+  /**
+   * Wait for the collective operations in flight
+   * to finish, then cancel the rest, so that no
+   * operation is still using the connections
+   * when the server is stopped.
+   */
+  private void stopCollectiveExecutor() {
+    collectiveExecutor.shutdown();
+    try {
+      if (!collectiveExecutor.awaitTermination(
+        Constant.TERMINATION_TIMEOUT,
+        TimeUnit.SECONDS)) {
+        LOG.error("Cancel the collective "
+          + "operations not completed.");
+        collectiveExecutor.shutdownNow();
+      }
+    } catch (InterruptedException e) {
+      LOG.error(
+        "Fail to wait for collective operations.",
+        e);
+      collectiveExecutor.shutdownNow();
+    }
+  }
+
   /**
    * Override this method to support collective
    * communications among Mappers
@@ -762,6 +1286,9 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
       if (client != null) {
         client.stop();
       }
+      if (collectiveExecutor != null) {
+        stopCollectiveExecutor();
+      }
       // Stop the server
       if (server != null) {
         server.stop();
@@ -781,6 +1308,10 @@ public class CollectiveMapper<KEYIN, VALUEIN, KEYOUT, VALUEOUT>
       throw new IOException(t);
     } finally {
       cleanup(context);
+      // The operations in flight record metrics
+      // until they complete
+      stopCollectiveExecutor();
+      reportMetrics(context);
       ConnPool.get().clean();
       client.stop();
       server.stop();
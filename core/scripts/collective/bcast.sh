@@ -23,4 +23,4 @@
 source env-config.sh
 
 #echo $HARP_CLASSPATH
-java -Xmx256m -Xms256m -classpath $HARP_CLASSPATH edu.iu.harp.collective.BcastCollective $1 $2 $3 $4 $5 $6
+java -Xmx256m -Xms256m -Dharp.transport=$HARP_TRANSPORT -classpath $HARP_CLASSPATH edu.iu.harp.collective.BcastCollective $1 $2 $3 $4 $5 $6
@@ -24,4 +24,4 @@
 source env-config.sh
 
 #echo $HARP_CLASSPATH
-java -Xmx256m -Xms256m -classpath $HARP_CLASSPATH edu.iu.harp.collective.EventCollective $1 $2 $3 $4
+java -Xmx256m -Xms256m -Dharp.transport=$HARP_TRANSPORT -classpath $HARP_CLASSPATH edu.iu.harp.collective.EventCollective $1 $2 $3 $4
@@ -32,3 +32,6 @@ for i in $HARP_HOME/**/target/harp-*.jar;
   do HARP_CLASSPATH=$i:${HARP_CLASSPATH}
 done
 
+
+# Transport backend of the collective micro-benchmarks: bio or nio
+export HARP_TRANSPORT=${HARP_TRANSPORT:-bio}
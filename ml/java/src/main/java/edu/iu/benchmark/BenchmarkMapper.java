@@ -17,13 +17,22 @@
 package edu.iu.benchmark;
 
 import edu.iu.harp.example.DoubleArrPlus;
+import edu.iu.harp.io.DataUtil;
 import edu.iu.harp.partition.Partition;
 import edu.iu.harp.partition.Table;
+import edu.iu.harp.resource.ByteArray;
 import edu.iu.harp.resource.DoubleArray;
+import edu.iu.harp.resource.Transferable;
+import edu.iu.harp.resource.Writable;
+import edu.iu.harp.resource.WritableRegistry;
+import edu.iu.harp.util.PartitionCount;
 import org.apache.hadoop.conf.Configuration;
 import org.apache.hadoop.mapred.CollectiveMapper;
 
 import java.io.IOException;
+import java.util.ArrayList;
+import java.util.Collections;
+import java.util.List;
 import java.util.Random;
 
 public class BenchmarkMapper extends
@@ -75,41 +84,10 @@ public class BenchmarkMapper extends
     int numWorkers = this.getNumWorkers();
     Random rand = new Random(workerID);
     if (cmd.equals("allreduce")) {
-      long startTime = System.currentTimeMillis();
-      for (int i = 0; i < numIterations; i++) {
-        Table<DoubleArray> arrTable =
-          new Table<>(i, new DoubleArrPlus());
-        // Create DoubleArray
-        int size = bytesPerPartition / 8;
-        for (int j = 0; j < numPartitions; j++) {
-          DoubleArray array =
-            DoubleArray.create(size, false);
-          array.get()[0] = rand.nextInt(1000);
-          array.get()[array.size() - 1] =
-            rand.nextInt(1000);
-          LOG.info("before allreduce: " + j + " "
-            + array.get()[0] + " "
-            + array.get()[array.size() - 1]);
-          arrTable.addPartition(
-            new Partition<>(j, array));
-        }
-        allreduce("main", "allreduce-" + i,
-          arrTable);
-        for (Partition<DoubleArray> partition : arrTable
-          .getPartitions()) {
-          DoubleArray array = partition.get();
-          LOG.info(
-            "after allreduce: " + partition.id()
-              + " " + array.get()[0] + " "
-              + array.get()[array.size() - 1]);
-        }
-        arrTable.release();
-      }
-      long endTime = System.currentTimeMillis();
-      LOG.info("Total allreduce time: "
-        + (endTime - startTime)
-        + " number of iterations: "
-        + numIterations);
+      runAllreduce(false, rand);
+      runAllreduce(true, rand);
+    } else if (cmd.equals("writable")) {
+      runWritableCodecs(rand);
     } else if (cmd.equals("allgather")) {
       long startTime = System.currentTimeMillis();
       for (int i = 0; i < numIterations; i++) {
@@ -150,4 +128,169 @@ public class BenchmarkMapper extends
         + (endTime - startTime));
     }
   }
+
+  /**
+   * Run the Writable codec with class names and
+   * with class IDs. The registry is emptied for
+   * the class names, then the classes registered
+   * from harp.writable.classes and the batch
+   * setting are restored.
+   *
+   * @param rand
+   *          the random generator
+   * @throws IOException
+   *           if the classes cannot be registered
+   */
+  private void runWritableCodecs(Random rand)
+    throws IOException {
+    WritableRegistry registry = WritableRegistry.get();
+    List<String> classNames =
+      registry.getClassNames();
+    boolean useBatch = registry.useBatch();
+    try {
+      // Class names, one by one
+      registry.reset();
+      registry.setUseBatch(false);
+      runWritableCodec("name", rand);
+      // Class name once per list
+      registry.setUseBatch(true);
+      runWritableCodec("name-batch", rand);
+      // Class ID once per list
+      List<Class<? extends Writable>> classes =
+        Collections.singletonList(
+          PartitionCount.class);
+      if (!registerWritables("main",
+        "register-writables", classes)) {
+        throw new IOException(
+          "Fail to register Writable classes.");
+      }
+      runWritableCodec("id-batch", rand);
+    } finally {
+      registry.reset();
+      if (!registry.register(classNames)) {
+        LOG.error("Fail to restore Writable classes "
+          + classNames);
+      }
+      registry.setUseBatch(useBatch);
+    }
+  }
+
+  /**
+   * Encode and decode a partition list of small
+   * Writables and report the throughput of the
+   * current WritableRegistry setting.
+   *
+   * @param mode
+   *          the name of the setting
+   * @param rand
+   *          the random generator
+   */
+  private void runWritableCodec(String mode,
+    Random rand) {
+    List<Transferable> partitions =
+      new ArrayList<>(numPartitions);
+    for (int j = 0; j < numPartitions; j++) {
+      PartitionCount count = new PartitionCount();
+      count.setWorkerID(rand.nextInt(1000));
+      count.setPartitionCount(rand.nextInt(1000));
+      partitions.add(new Partition<>(j, count));
+    }
+    long encodeTime = 0L;
+    long decodeTime = 0L;
+    long numBytes = 0L;
+    for (int i = 0; i < numIterations; i++) {
+      long time1 = System.nanoTime();
+      ByteArray byteArray =
+        DataUtil.encodeTransList(partitions);
+      long time2 = System.nanoTime();
+      List<Transferable> decoded =
+        DataUtil.decodePartitionList(byteArray);
+      long time3 = System.nanoTime();
+      encodeTime += time2 - time1;
+      decodeTime += time3 - time2;
+      numBytes += byteArray.size();
+      DataUtil.releaseTransList(decoded);
+      byteArray.release();
+    }
+    // Writables encoded or decoded per second
+    double numObjs =
+      (double) numPartitions * numIterations;
+    double encodeRate = 0.0;
+    double decodeRate = 0.0;
+    if (encodeTime > 0L) {
+      encodeRate = numObjs * 1.0e9 / encodeTime;
+    }
+    if (decodeTime > 0L) {
+      decodeRate = numObjs * 1.0e9 / decodeTime;
+    }
+    LOG.info("Writable codec (" + mode
+      + "): number of writables " + numPartitions
+      + " number of iterations: " + numIterations
+      + " bytes per writable: "
+      + (numBytes / numObjs)
+      + " encode (writables/s): " + encodeRate
+      + " decode (writables/s): " + decodeRate);
+  }
+
+  /**
+   * Run the allreduce iterations with one
+   * algorithm and report the bandwidth.
+   *
+   * @param useRing
+   *          if the ring algorithm is used
+   * @param rand
+   *          the random generator
+   */
+  private void runAllreduce(boolean useRing,
+    Random rand) {
+    String algorithm =
+      useRing ? "ring" : "doubling";
+    long totalTime = 0L;
+    long startTime = System.currentTimeMillis();
+    for (int i = 0; i < numIterations; i++) {
+      Table<DoubleArray> arrTable =
+        new Table<>(i, new DoubleArrPlus());
+      // Create DoubleArray
+      int size = bytesPerPartition / 8;
+      for (int j = 0; j < numPartitions; j++) {
+        DoubleArray array =
+          DoubleArray.create(size, false);
+        array.get()[0] = rand.nextInt(1000);
+        array.get()[array.size() - 1] =
+          rand.nextInt(1000);
+        LOG.info("before allreduce: " + j + " "
+          + array.get()[0] + " "
+          + array.get()[array.size() - 1]);
+        arrTable.addPartition(
+          new Partition<>(j, array));
+      }
+      long time1 = System.nanoTime();
+      allreduce("main",
+        "allreduce-" + algorithm + "-" + i,
+        arrTable, useRing);
+      totalTime += System.nanoTime() - time1;
+      for (Partition<DoubleArray> partition : arrTable
+        .getPartitions()) {
+        DoubleArray array = partition.get();
+        LOG.info(
+          "after allreduce: " + partition.id()
+            + " " + array.get()[0] + " "
+            + array.get()[array.size() - 1]);
+      }
+      arrTable.release();
+    }
+    long endTime = System.currentTimeMillis();
+    // Bytes of the table allreduced per second
+    double totalBytes = (double) bytesPerPartition
+      * numPartitions * numIterations;
+    double gbPerSec = 0.0;
+    if (totalTime > 0L) {
+      gbPerSec = totalBytes / totalTime;
+    }
+    LOG.info("Total allreduce time ("
+      + algorithm + "): " + (endTime - startTime)
+      + " number of iterations: " + numIterations
+      + " allreduce bandwidth (GB/s): "
+      + gbPerSec);
+  }
 }
@@ -0,0 +1,282 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.kmeans.regroupallgather;
+
+import edu.iu.harp.partition.Partition;
+import edu.iu.harp.partition.Table;
+import edu.iu.harp.resource.DoubleArray;
+
+import java.util.Arrays;
+import java.util.concurrent.ConcurrentHashMap;
+
+/*******************************************************
+ * The centroid state shared by the
+ * TriangleCenCalcTasks of a worker. Centroids
+ * are copied into one contiguous array without
+ * the count slot. After each update, it holds
+ * the drift of every centroid and half of the
+ * distance to its closest other centroid, which
+ * are the bounds used by Hamerly's algorithm.
+ * The per-point bounds are kept here too,
+ * because the scheduler can give a point array
+ * to a different task in each iteration.
+ ******************************************************/
+public class CenBounds {
+
+  private final int cenVecSize;
+  private final int vectorSize;
+  private int numCentroids;
+  private int iteration;
+  // Contiguous centroids, numCentroids * vectorSize
+  private double[] centroids;
+  private double[] prevCentroids;
+  // Where each centroid is in the table
+  private int[] cenParIDs;
+  private int[] cenOffsets;
+  private double[] drifts;
+  private double[] halfMinDistances;
+  private int maxDriftID;
+  private double maxDrift;
+  private double secondMaxDrift;
+  // Arrays hash by identity
+  private final ConcurrentHashMap<double[], PointBounds> pointBounds;
+
+  public CenBounds(int cenVecSize) {
+    this.cenVecSize = cenVecSize;
+    this.vectorSize = cenVecSize - 1;
+    this.numCentroids = 0;
+    this.iteration = -1;
+    this.pointBounds = new ConcurrentHashMap<>();
+  }
+
+  /**
+   * Copy the centroids in the table and
+   * compute the drifts and the half distances.
+   * Call it from one thread when the tasks are
+   * not running.
+   *
+   * @param cenTable
+   *          the centroids with the count slot
+   */
+  public void update(Table<DoubleArray> cenTable) {
+    int count = 0;
+    for (Partition<DoubleArray> partition : cenTable
+      .getPartitions()) {
+      count +=
+        partition.get().size() / cenVecSize;
+    }
+    boolean isNew = count != numCentroids;
+    if (isNew) {
+      numCentroids = count;
+      centroids =
+        new double[numCentroids * vectorSize];
+      prevCentroids =
+        new double[numCentroids * vectorSize];
+      cenParIDs = new int[numCentroids];
+      cenOffsets = new int[numCentroids];
+      drifts = new double[numCentroids];
+      halfMinDistances = new double[numCentroids];
+      // Old bounds refer to other centroids
+      pointBounds.clear();
+    }
+    double[] tmp = prevCentroids;
+    prevCentroids = centroids;
+    centroids = tmp;
+    int cenID = 0;
+    for (int i =
+      0; i < cenTable.getNumPartitions(); i++) {
+      DoubleArray array =
+        cenTable.getPartition(i).get();
+      double[] doubles = array.get();
+      int size = array.size();
+      for (int j = 0; j < size; j +=
+        cenVecSize) {
+        cenParIDs[cenID] = i;
+        cenOffsets[cenID] = j;
+        System.arraycopy(doubles, j + 1,
+          centroids, cenID * vectorSize,
+          vectorSize);
+        cenID++;
+      }
+    }
+    computeDrifts(isNew);
+    computeHalfMinDistances();
+    iteration++;
+  }
+
+  private void computeDrifts(boolean isNew) {
+    maxDriftID = -1;
+    maxDrift = 0.0;
+    secondMaxDrift = 0.0;
+    if (isNew) {
+      Arrays.fill(drifts, 0.0);
+      return;
+    }
+    for (int i = 0; i < numCentroids; i++) {
+      double drift = Math.sqrt(
+        distance(prevCentroids, i * vectorSize,
+          centroids, i * vectorSize,
+          vectorSize));
+      drifts[i] = drift;
+      if (drift > maxDrift) {
+        secondMaxDrift = maxDrift;
+        maxDrift = drift;
+        maxDriftID = i;
+      } else if (drift > secondMaxDrift) {
+        secondMaxDrift = drift;
+      }
+    }
+  }
+
+  private void computeHalfMinDistances() {
+    Arrays.fill(halfMinDistances,
+      Double.MAX_VALUE);
+    // Symmetric, compute each pair once
+    for (int i = 0; i < numCentroids; i++) {
+      for (int j = i + 1; j < numCentroids; j++) {
+        double distance = distance(centroids,
+          i * vectorSize, centroids,
+          j * vectorSize, vectorSize);
+        if (distance < halfMinDistances[i]) {
+          halfMinDistances[i] = distance;
+        }
+        if (distance < halfMinDistances[j]) {
+          halfMinDistances[j] = distance;
+        }
+      }
+    }
+    for (int i = 0; i < numCentroids; i++) {
+      halfMinDistances[i] =
+        0.5 * Math.sqrt(halfMinDistances[i]);
+    }
+  }
+
+  /**
+   * The squared Euclidean distance. The loop is
+   * unrolled with independent accumulators so
+   * the JIT can keep them in registers and
+   * overlap the additions.
+   */
+  public static double distance(double[] x,
+    int xStart, double[] y, int yStart,
+    int length) {
+    double d0 = 0.0;
+    double d1 = 0.0;
+    double d2 = 0.0;
+    double d3 = 0.0;
+    int i = 0;
+    for (; i + 3 < length; i += 4) {
+      double diff0 = x[xStart + i] - y[yStart + i];
+      double diff1 =
+        x[xStart + i + 1] - y[yStart + i + 1];
+      double diff2 =
+        x[xStart + i + 2] - y[yStart + i + 2];
+      double diff3 =
+        x[xStart + i + 3] - y[yStart + i + 3];
+      d0 += diff0 * diff0;
+      d1 += diff1 * diff1;
+      d2 += diff2 * diff2;
+      d3 += diff3 * diff3;
+    }
+    for (; i < length; i++) {
+      double diff = x[xStart + i] - y[yStart + i];
+      d0 += diff * diff;
+    }
+    return (d0 + d1) + (d2 + d3);
+  }
+
+  public int getNumCentroids() {
+    return numCentroids;
+  }
+
+  public int getVectorSize() {
+    return vectorSize;
+  }
+
+  public int getIteration() {
+    return iteration;
+  }
+
+  public double[] getCentroids() {
+    return centroids;
+  }
+
+  public int getCenParID(int cenID) {
+    return cenParIDs[cenID];
+  }
+
+  public int getCenOffset(int cenID) {
+    return cenOffsets[cenID];
+  }
+
+  public double getDrift(int cenID) {
+    return drifts[cenID];
+  }
+
+  public double getHalfMinDistance(int cenID) {
+    return halfMinDistances[cenID];
+  }
+
+  /**
+   * The max drift of the centroids other than
+   * the given one.
+   */
+  public double getMaxOtherDrift(int cenID) {
+    if (cenID == maxDriftID) {
+      return secondMaxDrift;
+    } else {
+      return maxDrift;
+    }
+  }
+
+  public PointBounds
+    getPointBounds(double[] points) {
+    PointBounds bounds = pointBounds.get(points);
+    if (bounds == null) {
+      bounds = new PointBounds(
+        points.length / cenVecSize);
+      PointBounds old =
+        pointBounds.putIfAbsent(points, bounds);
+      if (old != null) {
+        bounds = old;
+      }
+    }
+    return bounds;
+  }
+
+  /**
+   * The bounds of the points in one point
+   * array. Only one task works on a point array
+   * at a time.
+   */
+  public static class PointBounds {
+    public static final int NOT_INITIALIZED = -1;
+
+    final int[] assignments;
+    final double[] upperBounds;
+    final double[] lowerBounds;
+    // The centroid iteration of the bounds
+    int iteration;
+
+    PointBounds(int numPoints) {
+      assignments = new int[numPoints];
+      upperBounds = new double[numPoints];
+      lowerBounds = new double[numPoints];
+      iteration = NOT_INITIALIZED;
+    }
+  }
+}
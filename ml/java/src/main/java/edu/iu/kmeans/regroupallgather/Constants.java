@@ -35,4 +35,13 @@ public class Constants {
     "num_iterations";
   public static final String WORK_DIR =
     "work_dir";
+  public static final String CEN_CALC =
+    "cen_calc";
+
+  // Compute all the distances
+  public static final String CEN_CALC_LLOYD =
+    "lloyd";
+  // Skip distances by triangle inequality
+  public static final String CEN_CALC_TRIANGLE =
+    "triangle";
 }
\ No newline at end of file
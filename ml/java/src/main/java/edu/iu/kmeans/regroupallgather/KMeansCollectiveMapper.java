@@ -22,6 +22,7 @@ import edu.iu.harp.partition.Partitioner;
 import edu.iu.harp.partition.Table;
 import edu.iu.harp.resource.DoubleArray;
 import edu.iu.harp.schdynamic.DynamicScheduler;
+import edu.iu.harp.schdynamic.WorkStealingScheduler;
 import org.apache.hadoop.conf.Configuration;
 import org.apache.hadoop.fs.FSDataInputStream;
 import org.apache.hadoop.fs.FileSystem;
@@ -32,12 +33,16 @@ import java.io.BufferedReader;
 import java.io.File;
 import java.io.IOException;
 import java.io.InputStreamReader;
+import java.util.Arrays;
 import java.util.LinkedList;
 import java.util.List;
 
 public class KMeansCollectiveMapper extends
   CollectiveMapper<String, String, Object, Object> {
 
+  private static final String KMEANS_COUNTER_GROUP =
+    "KMeans";
+
   private int pointsPerFile;
   private int numCentroids;
   private int vectorSize;
@@ -47,6 +52,7 @@ public class KMeansCollectiveMapper extends
   private int numThreads;
   private int numIterations;
   private String cenDir;
+  private String cenCalc;
 
   /**
    * Mapper configuration.
@@ -72,6 +78,8 @@ public class KMeansCollectiveMapper extends
     numIterations = configuration
       .getInt(Constants.NUM_ITERATIONS, 10);
     cenDir = configuration.get(Constants.CEN_DIR);
+    cenCalc = configuration.get(Constants.CEN_CALC,
+      Constants.CEN_CALC_LLOYD);
     LOG.info("Points Per File " + pointsPerFile);
     LOG.info("Num Centroids " + numCentroids);
     LOG.info("Vector Size " + vectorSize);
@@ -79,6 +87,7 @@ public class KMeansCollectiveMapper extends
     LOG.info("Num Threads " + numThreads);
     LOG.info("Num Iterations " + numIterations);
     LOG.info("Cen Dir " + cenDir);
+    LOG.info("Cen Calc " + cenCalc);
     long endTime = System.currentTimeMillis();
     LOG.info(
       "config (ms) :" + (endTime - startTime));
@@ -125,14 +134,29 @@ public class KMeansCollectiveMapper extends
       KMUtil.loadPoints(fileNames, pointsPerFile,
         cenVecSize, conf, numThreads);
     // Initialize tasks
+    boolean useTriangle = cenCalc
+      .equals(Constants.CEN_CALC_TRIANGLE);
+    CenBounds cenBounds = null;
+    if (useTriangle) {
+      cenBounds = new CenBounds(cenVecSize);
+      cenBounds.update(cenTable);
+    }
     List<CenCalcTask> cenCalcTasks =
       new LinkedList<>();
     for (int i = 0; i < numThreads; i++) {
-      cenCalcTasks.add(
-        new CenCalcTask(cenTable, cenVecSize));
+      if (useTriangle) {
+        cenCalcTasks.add(new TriangleCenCalcTask(
+          cenTable, cenVecSize, cenBounds));
+      } else {
+        cenCalcTasks.add(
+          new CenCalcTask(cenTable, cenVecSize));
+      }
     }
-    DynamicScheduler<double[], Object, CenCalcTask> calcCompute =
-      new DynamicScheduler<>(cenCalcTasks);
+    long totalComputed = 0L;
+    long totalSkipped = 0L;
+    long totalIterationTime = 0L;
+    WorkStealingScheduler<double[], Object, CenCalcTask> calcCompute =
+      new WorkStealingScheduler<>(cenCalcTasks);
     List<CenMergeTask> tasks = new LinkedList<>();
     for (int i = 0; i < numThreads; i++) {
       tasks.add(
@@ -148,9 +172,7 @@ public class KMeansCollectiveMapper extends
       LOG.info("Iteration: " + i);
       // Calculate new centroids
       long t1 = System.currentTimeMillis();
-      for (double[] points : pointArrays) {
-        calcCompute.submit(points);
-      }
+      calcCompute.submitAll(pointArrays);
       while (calcCompute.hasOutput()) {
         calcCompute.waitForOutput();
       }
@@ -183,20 +205,63 @@ public class KMeansCollectiveMapper extends
       }
       allgather("main", "allgather-" + i,
         cenTable);
+      if (useTriangle) {
+        cenBounds.update(cenTable);
+      }
+      long numComputed = 0L;
+      long numSkipped = 0L;
       for (CenCalcTask task : calcCompute
         .getTasks()) {
         task.update(cenTable);
+        if (useTriangle) {
+          TriangleCenCalcTask triangleTask =
+            (TriangleCenCalcTask) task;
+          numComputed +=
+            triangleTask.getNumComputed();
+          numSkipped +=
+            triangleTask.getNumSkipped();
+          triangleTask.resetCounters();
+        }
       }
       long t4 = System.currentTimeMillis();
+      totalComputed += numComputed;
+      totalSkipped += numSkipped;
+      totalIterationTime += t4 - t1;
       LOG.info("Compute: " + (t2 - t1)
         + ", Merge: " + (t3 - t2)
-        + ", Aggregate: " + (t4 - t3));
+        + ", Aggregate: " + (t4 - t3)
+        + ", Iteration: " + (t4 - t1));
+      if (useTriangle) {
+        LOG.info("Distances computed: "
+          + numComputed + ", skipped: "
+          + numSkipped);
+      }
       logMemUsage();
       logGCTime();
       context.progress();
     }
     calcCompute.stop();
     mergeCompute.stop();
+    LOG.info("Compute tasks run: " + Arrays
+      .toString(calcCompute.getNumTasksRun())
+      + ", steals: " + Arrays
+        .toString(calcCompute.getNumSteals())
+      + ", idle (ns): " + Arrays
+        .toString(calcCompute.getIdleNanos()));
+    // Job counters are summed over the tasks, so
+    // the time is logged per task instead
+    LOG.info("Total iteration time (ms): "
+      + totalIterationTime);
+    if (useTriangle) {
+      context
+        .getCounter(KMEANS_COUNTER_GROUP,
+          "Distances computed")
+        .increment(totalComputed);
+      context
+        .getCounter(KMEANS_COUNTER_GROUP,
+          "Distances skipped")
+        .increment(totalSkipped);
+    }
     // Write out centroids
     if (this.isMaster()) {
       LOG.info("Start to write out centroids.");
@@ -55,7 +55,8 @@ public class KMeansLauncher extends Configured
           + "<num Of DataPoints> <num of Centroids> <vector size> "
           + "<num of point files per worker>"
           + "<number of map tasks> <num threads><number of iteration> "
-          + "<work dir> <local points dir>");
+          + "<work dir> <local points dir> "
+          + "[regenerate data] [lloyd|triangle]");
       ToolRunner
         .printGenericCommandUsage(System.err);
       return -1;
@@ -72,10 +73,21 @@ public class KMeansLauncher extends Configured
     String workDir = args[7];
     String localPointFilesDir = args[8];
     boolean regenerateData = true;
-    if (args.length == 10) {
+    if (args.length >= 10) {
       regenerateData =
         Boolean.parseBoolean(args[9]);
     }
+    String cenCalc = Constants.CEN_CALC_LLOYD;
+    if (args.length >= 11) {
+      cenCalc = args[10];
+    }
+    if (!cenCalc.equals(Constants.CEN_CALC_LLOYD)
+      && !cenCalc
+        .equals(Constants.CEN_CALC_TRIANGLE)) {
+      System.err.println(
+        "Unknown center calculation " + cenCalc);
+      return -1;
+    }
     System.out.println(
       "Number of Map Tasks = " + numMapTasks);
     int numPointFiles =
@@ -90,7 +102,8 @@ public class KMeansLauncher extends Configured
     launch(numOfDataPoints, numCentroids,
       vectorSize, numPointFiles, numMapTasks,
       numThreads, numIteration, workDir,
-      localPointFilesDir, regenerateData);
+      localPointFilesDir, regenerateData,
+      cenCalc);
     return 0;
   }
 
@@ -99,7 +112,8 @@ public class KMeansLauncher extends Configured
     int numPointFiles, int numMapTasks,
     int numThreads, int numIterations,
     String workDir, String localPointFilesDir,
-    boolean generateData) throws IOException,
+    boolean generateData, String cenCalc)
+    throws IOException,
     URISyntaxException, InterruptedException,
     ExecutionException, ClassNotFoundException {
     Configuration configuration = getConf();
@@ -129,7 +143,8 @@ public class KMeansLauncher extends Configured
     runKMeansAllReduce(numOfDataPoints,
       numCentroids, vectorSize, numPointFiles,
       numMapTasks, numThreads, numIterations,
-      dataDir, cenDir, outDir, configuration);
+      cenCalc, dataDir, cenDir, outDir,
+      configuration);
     long endTime = System.currentTimeMillis();
     System.out
       .println("Total K-means Execution Time: "
@@ -140,8 +155,9 @@ public class KMeansLauncher extends Configured
     int numOfDataPoints, int numCentroids,
     int vectorSize, int numPointFiles,
     int numMapTasks, int numThreads,
-    int numIterations, Path dataDir, Path cenDir,
-    Path outDir, Configuration configuration)
+    int numIterations, String cenCalc,
+    Path dataDir, Path cenDir, Path outDir,
+    Configuration configuration)
     throws IOException, URISyntaxException,
     InterruptedException, ClassNotFoundException {
     System.out.println("Starting Job");
@@ -156,7 +172,8 @@ public class KMeansLauncher extends Configured
       configureKMeansJob(numOfDataPoints,
         numCentroids, vectorSize, numPointFiles,
         numMapTasks, numThreads, numIterations,
-        dataDir, cenDir, outDir, configuration);
+        cenCalc, dataDir, cenDir, outDir,
+        configuration);
     System.out
       .println(
         "Job" + " configure in "
@@ -186,8 +203,9 @@ public class KMeansLauncher extends Configured
     int numOfDataPoints, int numCentroids,
     int vectorSize, int numPointFiles,
     int numMapTasks, int numThreads,
-    int numIterations, Path dataDir, Path cenDir,
-    Path outDir, Configuration configuration)
+    int numIterations, String cenCalc,
+    Path dataDir, Path cenDir, Path outDir,
+    Configuration configuration)
     throws IOException, URISyntaxException {
     Job job = Job.getInstance(configuration,
       "kmeans_job");
@@ -222,6 +240,7 @@ public class KMeansLauncher extends Configured
       numIterations);
     jobConfig.set(Constants.CEN_DIR,
       cenDir.toString());
+    jobConfig.set(Constants.CEN_CALC, cenCalc);
     return job;
   }
 }
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package edu.iu.kmeans.regroupallgather;
+
+import edu.iu.harp.partition.Table;
+import edu.iu.harp.resource.DoubleArray;
+
+/*******************************************************
+ * A CenCalcTask using Hamerly's algorithm. Each
+ * point keeps an upper bound of the distance to
+ * its centroid and a lower bound of the
+ * distance to any other centroid. The bounds
+ * are moved by the centroid drifts in each
+ * iteration, and the distances are computed
+ * only when the triangle inequality cannot
+ * prove that the assignment stays the same.
+ * The local sums are the same as CenCalcTask,
+ * so CenMergeTask and the collectives are
+ * unchanged.
+ ******************************************************/
+public class TriangleCenCalcTask
+  extends CenCalcTask {
+
+  private final CenBounds cenBounds;
+  private final int cenVecSize;
+  private long numComputed;
+  private long numSkipped;
+
+  public TriangleCenCalcTask(
+    Table<DoubleArray> cenTable, int cenVecSize,
+    CenBounds cenBounds) {
+    super(cenTable, cenVecSize);
+    this.cenBounds = cenBounds;
+    this.cenVecSize = cenVecSize;
+    this.numComputed = 0L;
+    this.numSkipped = 0L;
+  }
+
+  /**
+   * The number of point-centroid distances
+   * computed since the last reset.
+   */
+  public long getNumComputed() {
+    return numComputed;
+  }
+
+  /**
+   * The number of point-centroid distances
+   * skipped since the last reset.
+   */
+  public long getNumSkipped() {
+    return numSkipped;
+  }
+
+  public void resetCounters() {
+    numComputed = 0L;
+    numSkipped = 0L;
+  }
+
+  @Override
+  public Object run(double[] points)
+    throws Exception {
+    CenBounds.PointBounds bounds =
+      cenBounds.getPointBounds(points);
+    int iteration = cenBounds.getIteration();
+    // Bounds are valid only if they were
+    // updated against the previous centroids
+    boolean isValid = bounds.iteration
+      != CenBounds.PointBounds.NOT_INITIALIZED
+      && bounds.iteration == iteration - 1;
+    bounds.iteration = iteration;
+    int numCentroids = cenBounds.getNumCentroids();
+    int vectorSize = cenBounds.getVectorSize();
+    double[] centroids = cenBounds.getCentroids();
+    double[][] local = getLocal();
+    for (int i = 0, p =
+      0; i < points.length; i += cenVecSize, p++) {
+      int cenID;
+      if (!isValid) {
+        cenID = assign(points, i + 1, bounds, p);
+      } else {
+        cenID = bounds.assignments[p];
+        double upper = bounds.upperBounds[p]
+          + cenBounds.getDrift(cenID);
+        double lower = bounds.lowerBounds[p]
+          - cenBounds.getMaxOtherDrift(cenID);
+        double bound = Math.max(lower,
+          cenBounds.getHalfMinDistance(cenID));
+        int numSkippable = numCentroids;
+        if (upper > bound) {
+          // Tighten the upper bound
+          upper = Math.sqrt(CenBounds.distance(
+            points, i + 1, centroids,
+            cenID * vectorSize, vectorSize));
+          numComputed++;
+          numSkippable--;
+        }
+        if (upper > bound) {
+          cenID =
+            assign(points, i + 1, bounds, p);
+        } else {
+          bounds.upperBounds[p] = upper;
+          bounds.lowerBounds[p] = lower;
+          numSkipped += numSkippable;
+        }
+      }
+      int parID = cenBounds.getCenParID(cenID);
+      int offset = cenBounds.getCenOffset(cenID);
+      // Count + 1
+      local[parID][offset]++;
+      // Add the point
+      for (int j = 1; j < cenVecSize; j++) {
+        local[parID][offset + j] += points[i + j];
+      }
+    }
+    return null;
+  }
+
+  /**
+   * Compute the distances to all the centroids
+   * and reset the bounds of the point.
+   */
+  private int assign(double[] points,
+    int pStart, CenBounds.PointBounds bounds,
+    int p) {
+    int numCentroids = cenBounds.getNumCentroids();
+    int vectorSize = cenBounds.getVectorSize();
+    double[] centroids = cenBounds.getCentroids();
+    double minDistance = Double.MAX_VALUE;
+    double secondMinDistance = Double.MAX_VALUE;
+    int minCenID = 0;
+    for (int j = 0; j < numCentroids; j++) {
+      double distance =
+        CenBounds.distance(points, pStart,
+          centroids, j * vectorSize, vectorSize);
+      if (distance < minDistance) {
+        secondMinDistance = minDistance;
+        minDistance = distance;
+        minCenID = j;
+      } else if (distance < secondMinDistance) {
+        secondMinDistance = distance;
+      }
+    }
+    numComputed += numCentroids;
+    bounds.assignments[p] = minCenID;
+    bounds.upperBounds[p] = Math.sqrt(minDistance);
+    bounds.lowerBounds[p] =
+      Math.sqrt(secondMinDistance);
+    return minCenID;
+  }
+}
@@ -51,6 +51,8 @@ public class SCCollectiveMapper  extends CollectiveMapper<String, String, Object
     private int tpc;
     private long send_array_limit;
     private boolean rotation_pipeline;
+    private boolean send_cache;
+    private String dp_table;
     private String affinity;
 	boolean useLocalMultiThread;
 	int numModelSlices; // number of slices for pipeline optimization
@@ -72,6 +74,7 @@ public class SCCollectiveMapper  extends CollectiveMapper<String, String, Object
     	templateFile = configuration.get(SCConstants.TEMPLATE_PATH);
     	useLocalMultiThread = configuration.getBoolean(SCConstants.USE_LOCAL_MULTITHREAD, true);
     	rotation_pipeline = configuration.getBoolean(SCConstants.ROTATION_PIPELINE, true);
+        send_cache = configuration.getBoolean(SCConstants.SEND_CACHE, false);
 
     	LOG.info("init templateFile");
     	LOG.info(templateFile);
@@ -91,6 +94,9 @@ public class SCCollectiveMapper  extends CollectiveMapper<String, String, Object
         numIteration =configuration.getInt(SCConstants.NUM_ITERATION, 10);
         LOG.info("Subgraph Counting Iteration: " + numIteration);
 
+        dp_table = configuration.get(SCConstants.DP_TABLE, SCConstants.DP_TABLE_ARRAY);
+        LOG.info("DP table: " + dp_table);
+
 		numModelSlices = 2;
 	}
 
@@ -140,13 +146,13 @@ public class SCCollectiveMapper  extends CollectiveMapper<String, String, Object
 
 		// ---------------  main computation ----------------------------------
         colorcount_HJ graph_count = new colorcount_HJ();
-        graph_count.init(this, context, g_part, max_v_id, numThreads, numCores, tpc, affinity, false, false, true);
+        graph_count.init(this, context, g_part, max_v_id, numThreads, numCores, tpc, affinity, false, false, true, dp_table);
 
         // ------------------- generate communication information -------------------
         // send/recv num and verts 
         if (this.getNumWorkers() > 1)
         {
-            graph_count.init_comm(mapper_id_vertex, send_array_limit, rotation_pipeline);
+            graph_count.init_comm(mapper_id_vertex, send_array_limit, rotation_pipeline, send_cache);
             LOG.info("Finish graph_count initialization");
         }
 
@@ -14,7 +14,19 @@ public class SCConstants {
   public static final String TPC = "threads per core";
   public static final String SENDLIMIT = "mem per regroup array";
   public static final String ROTATION_PIPELINE = "use rotation-pipelined regroup";
+  // cache the compressed send data in pipelined rotation
+  public static final String SEND_CACHE = "cache compressed send data";
   public static final String NUM_ITERATION="num_itr";
+  // layout of the dynamic programming table
+  public static final String DP_TABLE = "dp table";
+  // one array per vertex
+  public static final String DP_TABLE_ARRAY = "array";
+  // contiguous blocks of rows on the Java heap
+  public static final String DP_TABLE_FLAT = "flat";
+  // contiguous blocks of rows in direct buffers
+  public static final String DP_TABLE_OFFHEAP = "offheap";
+  // contiguous blocks of rows in files mapped from the task's tmp dir
+  public static final String DP_TABLE_MMAP = "mmap";
   public static final int ARR_LEN = 16;
 
   public static final int NULL_VAL = Integer.MAX_VALUE;
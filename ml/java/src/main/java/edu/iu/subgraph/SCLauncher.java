@@ -67,7 +67,9 @@ public class SCLauncher extends Configured implements Tool {
                     "<mem per mapper>"+
                     "<mem per regroup array (MB)>"+
                     "<rotation-pipeline>" +
-                    "<num iteration>");
+                    "<num iteration>" +
+                    "[dp table: array|flat|offheap|mmap]" +
+                    "[send cache: true|false]");
 
 			ToolRunner.printGenericCommandUsage(System.err);
 			return -1;
@@ -86,6 +88,22 @@ public class SCLauncher extends Configured implements Tool {
         int send_array_limit = Integer.parseInt(args[10]);
         boolean rotation_pipeline = Boolean.parseBoolean(args[11]);
         int numIteration = Integer.parseInt(args[12]);
+        String dpTable = SCConstants.DP_TABLE_ARRAY;
+        if (args.length > 13) {
+            dpTable = args[13];
+        }
+        if (!SCConstants.DP_TABLE_ARRAY.equals(dpTable)
+                && !SCConstants.DP_TABLE_FLAT.equals(dpTable)
+                && !SCConstants.DP_TABLE_OFFHEAP.equals(dpTable)
+                && !SCConstants.DP_TABLE_MMAP.equals(dpTable)) {
+            System.err.println("Unknown dp table: " + dpTable
+                    + ", use array, flat, offheap or mmap");
+            return -1;
+        }
+        boolean sendCache = false;
+        if (args.length > 14) {
+            sendCache = Boolean.parseBoolean(args[14]);
+        }
 
 		System.out.println("use Local MultiThread? "+useLocalMultiThread);
 		System.out.println("set Number of Map Tasks = " + numMapTasks);
@@ -94,19 +112,21 @@ public class SCLauncher extends Configured implements Tool {
 		System.out.println("set number of cores per node: "+numCores);
 		System.out.println("set number of thd per core: "+ tpc);
 		System.out.println("set mem size per regroup array (MB): "+ send_array_limit);
+		System.out.println("set dp table: "+ dpTable);
+		System.out.println("set send cache: "+ sendCache);
 
-		launch(graphDir, template, outDir, numMapTasks, useLocalMultiThread, numThreads, numCores, affinity, tpc,  mem, send_array_limit, rotation_pipeline, numIteration);
+		launch(graphDir, template, outDir, numMapTasks, useLocalMultiThread, numThreads, numCores, affinity, tpc,  mem, send_array_limit, rotation_pipeline, numIteration, dpTable, sendCache);
 		return 0;
 	}
 
     public void launch(String graphDir, String template, String outDir, int numMapTasks, 
-            boolean useLocalMultiThread, int numThreads, int numCores, String affinity, int tpc, int mem, int send_array_limit, boolean rotation_pipeline, int numIteration) 
+            boolean useLocalMultiThread, int numThreads, int numCores, String affinity, int tpc, int mem, int send_array_limit, boolean rotation_pipeline, int numIteration, String dpTable, boolean sendCache) 
         throws ClassNotFoundException, IOException, InterruptedException{
 
 		boolean jobSuccess = true;
 		int jobRetryCount = 0;
 		Job scJob = configureSCJob(graphDir, template, outDir, 
-                numMapTasks, useLocalMultiThread, numThreads, numCores, affinity, tpc, mem, send_array_limit, rotation_pipeline, numIteration);
+                numMapTasks, useLocalMultiThread, numThreads, numCores, affinity, tpc, mem, send_array_limit, rotation_pipeline, numIteration, dpTable, sendCache);
 		// ----------------------------------------------------------
 		jobSuccess =scJob.waitForCompletion(true);
 		// ----------------------------------------------------------
@@ -114,7 +134,7 @@ public class SCLauncher extends Configured implements Tool {
 
 	private Job configureSCJob(String graphDir, String template, String outDir, int numMapTasks, 
             boolean useLocalMultiThread, int numThreads, int numCores, String affinity, int tpc, int mem, int send_array_limit, 
-            boolean rotation_pipeline, int numIteration) throws IOException  
+            boolean rotation_pipeline, int numIteration, String dpTable, boolean sendCache) throws IOException  
     {
 
 		Configuration configuration = getConf();
@@ -146,11 +166,16 @@ public class SCLauncher extends Configured implements Tool {
         // -Xmx120000m -Xms120000m
         int xmx = (mem - 5000) > (mem * 0.9)
             ? (mem - 5000) : (int) Math.ceil(mem * 0.9);
+        // off-heap tables take half of the memory outside the heap
+        int direct = SCConstants.DP_TABLE_OFFHEAP.equals(dpTable)
+            ? xmx / 2 : 0;
+        xmx -= direct;
         int xmn = (int) Math.ceil(0.25 * xmx);
         jobConf.set(
                 "mapreduce.map.collective.java.opts",
                 "-Xmx" + xmx + "m -Xms" + xmx + "m"
-                + " -Xmn" + xmn + "m");
+                + " -Xmn" + xmn + "m"
+                + (direct > 0 ? " -XX:MaxDirectMemorySize=" + direct + "m" : ""));
 
         jobConf.setNumMapTasks(numMapTasks);
 		jobConf.setInt("mapreduce.job.max.split.locations", 10000);
@@ -177,6 +202,8 @@ public class SCLauncher extends Configured implements Tool {
 
 		jobConfig.setBoolean(SCConstants.ROTATION_PIPELINE, rotation_pipeline);
 		jobConfig.setInt(SCConstants.NUM_ITERATION, numIteration);
+		jobConfig.set(SCConstants.DP_TABLE, dpTable);
+		jobConfig.setBoolean(SCConstants.SEND_CACHE, sendCache);
 
 		return job;
 	}
@@ -34,6 +34,11 @@ public class SCSet extends Writable {
 
   private short[] counts_index; //size == counts_num
 
+  // if not null, the counts of vertex i are at counts_pos[i] 
+  // of counts_data and counts_index, which are shared by sets
+  // and only written out, size == v_num
+  private int[] counts_pos;
+
 
   public SCSet() {
 
@@ -57,6 +62,26 @@ public class SCSet extends Writable {
       // this.counts_idx = counts_idx;
       this.counts_data = counts_data;
       this.counts_index = counts_index;
+      this.counts_pos = null;
+  }
+
+  /**
+   * @brief a set to send, whose counts are slices of 
+   * compressed arrays shared with other sets
+   *
+   * @param v_num
+   * @param counts_num
+   * @param v_offset offsets of counts in the set
+   * @param counts_pos start of counts of each vertex in the shared arrays
+   * @param counts_data shared counts
+   * @param counts_index shared indexes
+   */
+  public SCSet(int v_num, int counts_num, 
+          int[] v_offset, int[] counts_pos,
+          float[] counts_data, short[] counts_index) 
+  {
+      this(v_num, counts_num, v_offset, counts_data, counts_index);
+      this.counts_pos = counts_pos;
   }
 
   @Override
@@ -74,12 +99,29 @@ public class SCSet extends Writable {
       out.writeInt(v_offset[i]);
     }
     
-    for (int i = 0; i < counts_num; i++) {
-      out.writeFloat(counts_data[i]);
-    }
-
-    for (int i = 0; i < counts_num; i++) {
-      out.writeShort(counts_index[i]);
+    if (counts_pos == null) {
+        for (int i = 0; i < counts_num; i++) {
+          out.writeFloat(counts_data[i]);
+        }
+
+        for (int i = 0; i < counts_num; i++) {
+          out.writeShort(counts_index[i]);
+        }
+    } else {
+        // write the slice of each vertex
+        for (int i = 0; i < v_num; i++) {
+          int len = v_offset[i+1] - v_offset[i];
+          for (int j = counts_pos[i]; j < counts_pos[i] + len; j++) {
+            out.writeFloat(counts_data[j]);
+          }
+        }
+
+        for (int i = 0; i < v_num; i++) {
+          int len = v_offset[i+1] - v_offset[i];
+          for (int j = counts_pos[i]; j < counts_pos[i] + len; j++) {
+            out.writeShort(counts_index[j]);
+          }
+        }
     }
 
   }
@@ -90,6 +132,14 @@ public class SCSet extends Writable {
     v_num = in.readInt();
     counts_num = in.readInt();
 
+    // never read into the shared arrays
+    if (counts_pos != null)
+    {
+        counts_pos = null;
+        counts_data = new float[counts_num];
+        counts_index = new short[counts_num];
+    }
+
     if (v_offset.length < (v_num + 1))
     {
         v_offset = null;
@@ -138,11 +188,34 @@ public class SCSet extends Writable {
   }
 
   public float[] get_counts_data(){
+      copy_shared_counts();
       return counts_data;
   }
 
   public short[] get_counts_index(){
+      copy_shared_counts();
       return counts_index;
   }
 
+  /**
+   * @brief copy the slices out of the shared arrays
+   * if the set is read without being sent
+   */
+  private void copy_shared_counts(){
+      if (counts_pos == null)
+          return;
+
+      float[] data = new float[counts_num];
+      short[] index = new short[counts_num];
+      for (int i = 0; i < v_num; i++) {
+          int len = v_offset[i+1] - v_offset[i];
+          System.arraycopy(counts_data, counts_pos[i], data, v_offset[i], len);
+          System.arraycopy(counts_index, counts_pos[i], index, v_offset[i], len);
+      }
+
+      counts_pos = null;
+      counts_data = data;
+      counts_index = index;
+  }
+
 }
@@ -56,6 +56,7 @@ import net.openhft.affinity.Affinity;
 
 // for triggering vtune 
 import java.nio.file.*;
+import java.io.File;
 import java.io.IOException;
 
 // for hadoop assert
@@ -99,7 +100,7 @@ public class colorcount_HJ {
 
     // ----------------------------- for dynamic programming  -----------------------------
     //store counts in dynamic programming table
-    dynamic_table_array dt;
+    dynamic_table dt;
 
     // current active and passive template id for debug use
     private int active_child;
@@ -185,10 +186,15 @@ public class colorcount_HJ {
     private float[][][] update_queue_counts;
     private short[][][] update_queue_index;
 
-    //cache the compressed sending data
-    private float[][] compress_cache_array; 
-    private short[][] compress_cache_index; 
-    private int[] compress_cache_len;
+    //cache the compressed sending data of all the requested local verts
+    //counts of rel_v_id are at compress_cache_pos[v] .. compress_cache_pos[v+1]
+    private int[] compress_cache_pos;
+    private float[] compress_cache_counts; 
+    private short[] compress_cache_index; 
+    //the cache exceeds the max array size or send_array_limit
+    private boolean compress_cache_disabled = false;
+    //use the cache in pipelined rotation, off by default
+    private boolean send_cache = false;
 
     // cache the rel pos of adj for each local v in pipeline rotation
     private int[][] map_ids_cache_pip;
@@ -251,8 +257,9 @@ public class colorcount_HJ {
      * @param do_gdd
      * @param do_vert
      * @param verb
+     * @param dp_table SCConstants.DP_TABLE_ARRAY, DP_TABLE_FLAT, DP_TABLE_OFFHEAP or DP_TABLE_MMAP
      */
-    void init(SCCollectiveMapper mapper, Context context, Graph local_graph, int global_max_v_id, int thread_num, int core_num, int tpc, String affinity, boolean do_gdd, boolean do_vert, boolean verb)
+    void init(SCCollectiveMapper mapper, Context context, Graph local_graph, int global_max_v_id, int thread_num, int core_num, int tpc, String affinity, boolean do_gdd, boolean do_vert, boolean verb, String dp_table)
     {
         // assign params
         this.mapper = mapper;
@@ -277,7 +284,16 @@ public class colorcount_HJ {
         this.count_local_root = new double[this.thread_num];
         this.count_comm_root = new double[this.thread_num];
 
-        this.dt = new dynamic_table_array();
+        if (SCConstants.DP_TABLE_FLAT.equals(dp_table))
+            this.dt = new dynamic_table_flat(false);
+        else if (SCConstants.DP_TABLE_OFFHEAP.equals(dp_table))
+            this.dt = new dynamic_table_flat(true);
+        else if (SCConstants.DP_TABLE_MMAP.equals(dp_table))
+            this.dt = new dynamic_table_flat(new File(System.getProperty("java.io.tmpdir")));
+        else if (SCConstants.DP_TABLE_ARRAY.equals(dp_table))
+            this.dt = new dynamic_table_array();
+        else
+            throw new IllegalArgumentException("Unknown dp table: " + dp_table);
         this.barrier = new CyclicBarrier(this.thread_num);
 
         if( do_graphlet_freq || do_vert_output){
@@ -291,14 +307,17 @@ public class colorcount_HJ {
      *
      * @param mapper_id_vertex
      * @param mapper
+     * @param send_cache compress the requested verts once per subtemplate 
+     * in pipelined rotation, the cache is capped by send_array_limit
      */
-    void init_comm(int[] mapper_id_vertex, long send_array_limit, boolean rotation_pipeline) 
+    void init_comm(int[] mapper_id_vertex, long send_array_limit, boolean rotation_pipeline, boolean send_cache) 
     {
         
         //create abs mapping structure
         this.abs_v_to_mapper = mapper_id_vertex;
         this.send_array_limit = send_array_limit;
         this.rotation_pipeline = rotation_pipeline;
+        this.send_cache = send_cache;
 
         // init members
         this.mapper_num = this.mapper.getNumWorkers();
@@ -336,9 +355,6 @@ public class colorcount_HJ {
         this.comm_vertex_table = new Table<>(0, new IntArrPlus());
         this.send_vertex_table = new Table<>(0, new IntArrPlus());
 
-        this.compress_cache_array = new float[this.num_verts_graph][];
-        this.compress_cache_index = new short[this.num_verts_graph][];
-        this.compress_cache_len = new int[this.num_verts_graph];
 
         this.map_ids_cache_pip = new int[this.num_verts_graph][];
         this.chunk_ids_cache_pip = new int[this.num_verts_graph][];
@@ -749,8 +765,7 @@ public class colorcount_HJ {
         this.update_map = null;
         this.colors_g = null;
 
-        this.compress_cache_array = null;
-        this.compress_cache_index = null;
+        release_compress_cache();
 
         this.map_ids_cache_pip = null;
         this.chunk_ids_cache_pip = null;
@@ -882,6 +897,10 @@ public class colorcount_HJ {
         assert(valid_nbrs != null);
         int valid_nbrs_count = 0;
 
+        // buffers of the active counts and the summed passive counts 
+        float[] counts_a_buf = new float[dt.get_num_color_set(part.get_active_index(s))];
+        double[] counts_p_sum = new double[dt.get_num_color_set(part.get_passive_index(s))];
+
         // each thread for a chunk
         // loop by relative v_id
         for (int v = chunks[threadIdx]; v < chunks[threadIdx + 1]; ++v) 
@@ -898,11 +917,6 @@ public class colorcount_HJ {
                 int[] adjs_abs = g.adjacent_vertices(v);
                 int end = g.out_degree(v);
 
-                //indexed by comb number
-                //counts of v at active child
-                float[] counts_a = dt.get_active(v);
-
-
                 //loop overall its neighbours
                 int nbr_comm_itr = 0;
                 for(int i = 0; i < end; ++i)
@@ -922,6 +936,17 @@ public class colorcount_HJ {
 
                 if(valid_nbrs_count != 0){
 
+                    //indexed by comb number
+                    //counts of v at active child
+                    float[] counts_a = dt.get_active(v, counts_a_buf);
+
+                    // the combination is linear in the passive counts,
+                    // so sum the rows of all the valid nbrs once
+                    // instead of going through the nbrs for each color comb
+                    //validated nbrs already checked to be on passive child
+                    Arrays.fill(counts_p_sum, 0.0d);
+                    dt.add_passive(valid_nbrs, valid_nbrs_count, counts_p_sum);
+
                     //add counts on local nbs
                     //number of colors for template s
                     //different from num_combinations_ato, which is for active child
@@ -931,28 +956,8 @@ public class colorcount_HJ {
                     // first loop on different color_combs of cur subtemplate
                     for(int n = 0; n < num_combinations_verts_sub; ++n){
 
-                        double color_count = 0.0f;
-
-                        // more details
-                        int[] comb_indexes_a = comb_num_indexes[0][s][n];
-                        int[] comb_indexes_p = comb_num_indexes[1][s][n];
-                        int p = num_combinations_ato -1;
-
-                        // second loop on different color_combs of active/passive children
-                        // a+p == num_combinations_ato 
-                        // (total colorscombs for both of active child and pasive child)
-                        for(int a = 0; a < num_combinations_ato; ++a, --p){
-
-                            float count_a = counts_a[comb_indexes_a[a]];
-                            if( count_a > 0){
-
-                                //third loop on different valid nbrs
-                                for(int i = 0; i < valid_nbrs_count; ++i){
-                                    //validated nbrs already checked to be on passive child
-                                    color_count += (double)count_a * dt.get_passive(valid_nbrs[i], comb_indexes_p[p]);
-                                }
-                            }
-                        }
+                        double color_count = combine_counts(counts_a, counts_p_sum, 
+                                comb_num_indexes[0][s][n], comb_num_indexes[1][s][n], num_combinations_ato);
 
                         if( color_count > 0.0){
                         
@@ -975,9 +980,38 @@ public class colorcount_HJ {
         }
 
         valid_nbrs = null;
+        counts_a_buf = null;
+        counts_p_sum = null;
         barrier.await();
     }
 
+    /**
+     * @brief combine the counts of active and passive children 
+     * for one color comb of the subtemplate
+     *
+     * @param counts_a counts of active child
+     * @param counts_p counts of passive child
+     * @param comb_indexes_a
+     * @param comb_indexes_p
+     * @param num_combinations color combs of active child
+     *
+     * @return 
+     */
+    private static double combine_counts(float[] counts_a, double[] counts_p, 
+            int[] comb_indexes_a, int[] comb_indexes_p, int num_combinations)
+    {
+        double color_count = 0.0d;
+        // a+p == num_combinations 
+        // (total colorscombs for both of active child and pasive child)
+        int p = num_combinations - 1;
+        for(int a = 0; a < num_combinations; ++a, --p){
+            float count_a = counts_a[comb_indexes_a[a]];
+            if( count_a > 0)
+                color_count += (double)count_a * counts_p[comb_indexes_p[p]];
+        }
+        return color_count;
+    }
+
     /**
      * @brief obtain the hash values table for each subtemplate and a combination of color sets
      *
@@ -1474,8 +1508,9 @@ public class colorcount_HJ {
 
                 //comm_id (32 bits) consists of three parts: 1) send_id (12 bits); 2) local mapper_id (12 bits) 3) array_parcel id (8 bits)
                 int comm_id =  ((send_id << 20) | (this.local_mapper_id << 8) | j );
-                SCSet comm_data = compress_send_data(send_chunk_list, comb_len);
-                // SCSet comm_data = compress_send_data_cached(send_chunk_list, comb_len);
+                // with the cache, a vert requested by several mappers is compressed once
+                SCSet comm_data = this.send_cache ? compress_send_data_cached(send_chunk_list, comb_len)
+                    : compress_send_data(send_chunk_list, comb_len);
                 this.comm_data_table.addPartition(new Partition<>(comm_id, comm_data));
             }
 
@@ -1597,8 +1632,10 @@ public class colorcount_HJ {
             LOG.info(" Comb len: " + comb_len);
         }
 
-        // this decompress counts will be reused
-        float[] decompress_counts = new float[comb_len];
+        // buffer of the counts on active child
+        float[] counts_a_buf = new float[this.dt.get_num_color_set(active_index)];
+        // the decompressed counts of all the remote nbrs are summed here
+        double[] decompress_sum = new double[comb_len];
         // accumulate the updates on a n position, then writes to the dt table
         double[] update_at_n = new double[num_combinations_verts_sub];
 
@@ -1621,15 +1658,19 @@ public class colorcount_HJ {
 
                 // store the abs adj id for v
                 int[] adj_list = this.update_map[v]; 
-                float[] counts_a = dt.get_active(v);
 
                 int[] map_ids = this.map_ids_cache_pip[v];
                 int[] chunk_ids = this.chunk_ids_cache_pip[v]; 
                 int[] chunk_internal_offsets = this.chunk_internal_offsets_cache_pip[v];
 
                 int compress_interval = 0;
+                boolean has_counts = false;
+
+                for(int x = 0; x<comb_len; x++ )
+                    decompress_sum[x] = 0.0d;
 
                 //second loop over nbrs, decompress adj from Scset
+                //and sum them up
                 for(int i = 0; i< adj_list_size; i++)
                 {
                     int[] adj_offset_list = this.update_queue_pos[map_ids[i]][chunk_ids[i]];
@@ -1648,45 +1689,34 @@ public class colorcount_HJ {
                         float[] adj_counts_list = this.update_queue_counts[map_ids[i]][chunk_ids[i]];
                         short[] adj_index_list = this.update_queue_index[map_ids[i]][chunk_ids[i]];
 
-                        // ----------- start decompress process -----------
-                        for(int x = 0; x<comb_len; x++ )
-                            decompress_counts[x] = 0.0f;
-
                         for(int x = 0; x< compress_interval; x++)
-                            decompress_counts[(int)adj_index_list[start_pos + x]] = adj_counts_list[start_pos + x];
-
-                        // ----------- Finish decompress process -----------
+                            decompress_sum[(int)adj_index_list[start_pos + x]] += adj_counts_list[start_pos + x];
 
-                        //third loop over comb_num for cur subtemplate
-                        for(int n = 0; n< num_combinations_verts_sub; n++)
-                        {
-                            // more details
-                            int[] comb_indexes_a = comb_num_indexes[0][sub_id][n];
-                            int[] comb_indexes_p = comb_num_indexes[1][sub_id][n];
-
-                            // for passive 
-                            int p = num_combinations_active_ato -1;
+                        has_counts = true;
 
-                            // fourth loop over comb_num for active/passive subtemplates
-                            for(int a = 0; a < num_combinations_active_ato; ++a, --p)
-                            {
-                                float count_a = counts_a[comb_indexes_a[a]];
-                                if (count_a > 0)
-                                {
-                                    update_at_n[n] += ((double)count_a*decompress_counts[comb_indexes_p[p]]);
-                                }
+                    } // finish all nonzero adj
 
-                            }
+                } // finish all adj of a v
 
-                        } // finish all combination sets for cur template
+                if (!has_counts)
+                    continue;
 
-                    } // finish all nonzero adj
+                float[] counts_a = dt.get_active(v, counts_a_buf);
 
-                } // finish all adj of a v
+                //third loop over comb_num for cur subtemplate
+                //all the nbrs are combined at once
+                for(int n = 0; n< num_combinations_verts_sub; n++)
+                {
+                    update_at_n[n] = combine_counts(counts_a, decompress_sum, 
+                            comb_num_indexes[0][sub_id][n], comb_num_indexes[1][sub_id][n], num_combinations_active_ato);
+                }
 
                 //write upated value 
                 for(int n = 0; n< num_combinations_verts_sub; n++)
                 {
+                    if (update_at_n[n] == 0.0d)
+                        continue;
+
                     if (sub_id != 0)
                         dt.update_comm(v, comb_num_indexes_set[sub_id][n], (float)update_at_n[n]);
                     else
@@ -1705,7 +1735,8 @@ public class colorcount_HJ {
         if (this.verbose && threadIdx == 0)
             LOG.info("Thd 0 finished all the vertices");
 
-        decompress_counts = null;
+        counts_a_buf = null;
+        decompress_sum = null;
         update_at_n = null;
 
         barrier.await();
@@ -1748,8 +1779,10 @@ public class colorcount_HJ {
         if (verbose && threadIdx == 1)
             LOG.info(" Comb len: " + comb_len);
 
-        // this decompress counts will be reused
-        float[] decompress_counts = new float[comb_len];
+        // buffer of the counts on active child
+        float[] counts_a_buf = new float[this.dt.get_num_color_set(active_index)];
+        // the decompressed counts of all the remote nbrs are summed here
+        double[] decompress_sum = new double[comb_len];
         // accumulate the updates on a n position, then writes to the dt table
         double[] update_at_n = new double[num_combinations_verts_sub];
 
@@ -1774,17 +1807,20 @@ public class colorcount_HJ {
                 // store the abs adj id for v
                 int[] adj_list = this.update_map[v]; 
                 // assertTrue("adj_list null", (adj_list != null));
-                float[] counts_a = dt.get_active(v);
-                // assertTrue("counts_a null", (counts_a != null));
 
                 int compress_interval = 0;
+                boolean has_counts = false;
 
                 // retrieve map_id and chunk id for each adj in adj_list
                 int[] map_ids = this.map_ids_cache_pip[v];
                 int[] chunk_ids = this.chunk_ids_cache_pip[v]; 
                 int[] chunk_internal_offsets = this.chunk_internal_offsets_cache_pip[v];
 
+                for(int x = 0; x<comb_len; x++ )
+                    decompress_sum[x] = 0.0d;
+
                 //second loop over nbrs, decompress adj from Scset
+                //and sum them up
                 for(int rand_i = 0; rand_i< adj_list_size; rand_i++)
                 {
 
@@ -1810,61 +1846,34 @@ public class colorcount_HJ {
                         float[] adj_counts_list = this.update_queue_counts[map_ids[rand_i]][chunk_ids[rand_i]];
                         short[] adj_index_list = this.update_queue_index[map_ids[rand_i]][chunk_ids[rand_i]];
 
-
-                        // assertTrue("adj_counts_list null", (adj_counts_list != null));
-                        // assertTrue("adj_index_list null", (adj_index_list != null));
-
-                        // ----------- start decompress process -----------
-                        for(int x = 0; x<comb_len; x++ )
-                            decompress_counts[x] = 0.0f;
-
-                        // assertTrue("compress_interval negative", (compress_interval > 0));
-
                         for(int x = 0; x< compress_interval; x++)
-                        {
-                            // assertTrue("adj index out of bound", (adj_index_list[start_pos + x] < comb_len  && adj_index_list[start_pos + x] >=0 ));
-                            // assertTrue(" adj counts list out of bound", (start_pos + x < adj_counts_list.length));
-                            decompress_counts[(int)adj_index_list[start_pos + x]] = adj_counts_list[start_pos + x];
-                        }
+                            decompress_sum[(int)adj_index_list[start_pos + x]] += adj_counts_list[start_pos + x];
 
-                        // ----------- Finish decompress process -----------
+                        has_counts = true;
 
-                        //third loop over comb_num for cur subtemplate
-                        for(int n = 0; n< num_combinations_verts_sub; n++)
-                        {
-                            // more details
-                            int[] comb_indexes_a = this.comb_num_indexes[0][sub_id][n];
-                            int[] comb_indexes_p = this.comb_num_indexes[1][sub_id][n];
-
-                            // assertTrue("comb_indexes_a null", (comb_indexes_a != null));
-                            // assertTrue("comb_indexes_p null", (comb_indexes_p != null));
-
-                            // for passive 
-                            int p = num_combinations_active_ato -1;
-                            //
-                            // fourth loop over comb_num for active/passive subtemplates
-                            for(int a = 0; a < num_combinations_active_ato; ++a, --p)
-                            {
-                                // assertTrue("counts_a null", (counts_a != null));
-                                // assertTrue("a out of bound ", (a < comb_indexes_a.length));
-                                // assertTrue("comb_indexes_a not in range", (comb_indexes_a[a] < counts_a.length));
-                                float count_a = counts_a[comb_indexes_a[a]];
-                                if (count_a > 0)
-                                {
-                                    update_at_n[n] += ((double)count_a*decompress_counts[comb_indexes_p[p]]);
-                                }
+                    } // finish all nonzero adj
 
-                            }
+                } // finish all adj of a v
 
-                        } // finish all combination sets for cur template
+                if (!has_counts)
+                    continue;
 
-                    } // finish all nonzero adj
+                float[] counts_a = dt.get_active(v, counts_a_buf);
 
-                } // finish all adj of a v
+                //third loop over comb_num for cur subtemplate
+                //all the nbrs are combined at once
+                for(int n = 0; n< num_combinations_verts_sub; n++)
+                {
+                    update_at_n[n] = combine_counts(counts_a, decompress_sum, 
+                            this.comb_num_indexes[0][sub_id][n], this.comb_num_indexes[1][sub_id][n], num_combinations_active_ato);
+                }
 
                 //write upated value 
                 for(int n = 0; n< num_combinations_verts_sub; n++)
                 {
+                    if (update_at_n[n] == 0.0d)
+                        continue;
+
                     if (sub_id != 0)
                         dt.update_comm(v, comb_num_indexes_set[sub_id][n], (float)update_at_n[n]);
                     else
@@ -1883,17 +1892,96 @@ public class colorcount_HJ {
         if (this.verbose && threadIdx == 1)
             LOG.info("Trace update counts for Thd 1 Finished");
 
-        decompress_counts = null;
+        counts_a_buf = null;
+        decompress_sum = null;
         update_at_n = null;
 
         if (verbose && threadIdx == 1)
             LOG.info("Finish updating remote counts from mapper: "+update_mapper_id + " on local vertex");
     }
 
+    /**
+     * @brief compress the passive counts of all the local verts 
+     * requested by remote mappers into one pair of arrays. 
+     * It is done once per subtemplate and reused in each rotation.
+     * single thread
+     *
+     * @return false if the cache exceeds the max array size
+     */
+    private boolean build_compress_cache()
+    {
+        int[] cache_pos = new int[this.num_verts_graph + 1];
+        boolean[] requested = new boolean[this.num_verts_graph];
+
+        // first pass counts the nonzero counts of each requested vert
+        for(int send_id : this.send_vertex_table.getPartitionIDs())
+        {
+            int[] comm_vert_list = this.send_vertex_table.getPartition(send_id).get().get();
+            for(int i = 0; i< comm_vert_list.length; i++)
+            {
+                int rel_vert_id = this.g.get_relative_v_id(comm_vert_list[i]); 
+                if (rel_vert_id < 0 || requested[rel_vert_id] || (this.dt.is_vertex_init_passive(rel_vert_id) == false))
+                    continue;
+
+                requested[rel_vert_id] = true;
+                cache_pos[rel_vert_id + 1] = this.dt.count_passive(rel_vert_id);
+            }
+        }
+
+        requested = null;
+
+        long count_num = 0;
+        for(int v = 0; v< this.num_verts_graph; v++)
+        {
+            count_num += cache_pos[v + 1];
+            if (count_num > Integer.MAX_VALUE - 8)
+            {
+                LOG.info("Compressed counts exceed the max array size, disable the cache");
+                return false;
+            }
+            cache_pos[v + 1] = (int)count_num;
+        }
+
+        // the cache stays in memory for the whole subtemplate, 
+        // keep it within the memory of one send array
+        if (count_num*6L > this.send_array_limit)
+        {
+            LOG.info("Compressed counts cache of " + (count_num*6L) + " bytes exceeds the send array limit, disable the cache");
+            return false;
+        }
+
+        // second pass compresses the passive counts from the table
+        // directly into the cache
+        float[] cache_counts = new float[(int)count_num];
+        short[] cache_index = new short[(int)count_num];
+        for(int v = 0; v< this.num_verts_graph; v++)
+        {
+            if (cache_pos[v + 1] != cache_pos[v])
+                this.dt.compress_passive(v, cache_counts, cache_index, cache_pos[v]);
+        }
+
+        this.compress_cache_pos = cache_pos;
+        this.compress_cache_counts = cache_counts;
+        this.compress_cache_index = cache_index;
+
+        if (this.verbose)
+            LOG.info("Compressed counts cache size: " + count_num + "; mem usage: " + (count_num*6));
+
+        return true;
+    }
+
+    private void release_compress_cache()
+    {
+        this.compress_cache_pos = null;
+        this.compress_cache_counts = null;
+        this.compress_cache_index = null;
+        this.compress_cache_disabled = false;
+    }
+
     /**
      * @brief compress local vert data for remote mappers
-     * cache the compressed data of each local v into a global lookup table
-     * this will consume more memory space
+     * the set refers to the slices of the compressed cache 
+     * and writes them out when it is sent, without copying
      * single thread
      *
      * @param vert_list
@@ -1904,19 +1992,17 @@ public class colorcount_HJ {
     public SCSet compress_send_data_cached(int[] vert_list, int num_comb_max) 
     {
 
+        if (this.compress_cache_pos == null && !this.compress_cache_disabled)
+            this.compress_cache_disabled = !build_compress_cache();
+
+        if (this.compress_cache_disabled)
+            return compress_send_data(vert_list, num_comb_max);
+
         this.start_comm = System.currentTimeMillis();
 
         int v_num = vert_list.length;
         int[] v_offset = new int[v_num + 1];
-
-        //to be trimed
-        //counts_idx_tmp is not required, can be removed
-        float[] counts_data_tmp = new float[num_comb_max*v_num];
-        // float[] compress_array = new float[num_comb_max];
-
-        // compress index uses short to save memory, support up to 32767 as max_comb_len
-        short[] counts_index_tmp = new short[num_comb_max*v_num];
-        // short[] compress_index = new short[num_comb_max];
+        int[] counts_pos = new int[v_num];
 
         int count_num = 0;
         int effective_v = 0;
@@ -1925,103 +2011,24 @@ public class colorcount_HJ {
         {
             v_offset[i] = count_num;
             //get the abs vert id
-            int comm_vert_id = vert_list[i];
-            int rel_vert_id = this.g.get_relative_v_id(comm_vert_id); 
+            int rel_vert_id = this.g.get_relative_v_id(vert_list[i]); 
 
             //if comm_vert_id is not in local graph
-            if (rel_vert_id < 0 || (this.dt.is_vertex_init_passive(rel_vert_id) == false))
+            if (rel_vert_id < 0)
                 continue;
 
-            // float[] counts_arry = null; 
-            float[] compress_counts = this.compress_cache_array[rel_vert_id];
-            short[] compress_index = this.compress_cache_index[rel_vert_id];
-
-            if (compress_counts == null)
-            {
-                //compress the sending counts and index
-                float[] counts_raw = this.dt.get_passive(rel_vert_id);
-                if (counts_raw == null)
-                {
-                    LOG.info("ERROR: null passive counts array");
-                    continue;
-                }
-            
-                //check length 
-                if (counts_raw.length != num_comb_max)
-                {
-                    LOG.info("ERROR: comb_max and passive counts len not matched");
-                    continue;
-                }
-
-                // further compress nonzero values
-                // float[] compress_counts_tmp = new float[num_comb_max];
-                // short[] compress_index_tmp = new short[num_comb_max];
-                // int compress_itr = 0;
-                // for(int j=0; j<counts_raw.length; j++)
-                // {
-                //     if (counts_raw[j] > 0.0f)
-                //     {
-                //         compress_counts_tmp[compress_itr] = counts_raw[j];
-                //         compress_index_tmp[compress_itr] = (short)j;
-                //         compress_itr++;
-                //     }
-                // }
-                // // trim the tmp arrays
-                // compress_counts = new float[compress_itr];
-                // compress_index = new short[compress_itr];
-                // System.arraycopy(compress_counts_tmp, 0, compress_counts, 0, compress_itr);
-                // System.arraycopy(compress_index_tmp, 0, compress_index, 0, compress_itr);
-
-                // further compress nonzero values
-                compress_counts = new float[num_comb_max];
-                compress_index = new short[num_comb_max];
-
-                int compress_itr = 0;
-                for(int j=0; j<counts_raw.length; j++)
-                {
-                    if (counts_raw[j] > 0.0f)
-                    {
-                        compress_counts[compress_itr] = counts_raw[j];
-                        compress_index[compress_itr] = (short)j;
-                        compress_itr++;
-                    }
-                }
-                
-                //store compress data in the table
-                this.compress_cache_array[rel_vert_id] = compress_counts;
-                this.compress_cache_index[rel_vert_id] = compress_index;
-                this.compress_cache_len[rel_vert_id] = compress_itr;
-
-                // compress_counts_tmp = null;
-                // compress_index_tmp = null;
-            }
-
-            int compress_len = this.compress_cache_len[rel_vert_id];
+            int compress_len = this.compress_cache_pos[rel_vert_id + 1] - this.compress_cache_pos[rel_vert_id];
+            if (compress_len == 0)
+                continue;
 
             effective_v++;
-
-            // System.arraycopy(compress_counts, 0, counts_data_tmp, count_num, compress_counts.length);
-            // System.arraycopy(compress_index, 0, counts_index_tmp, count_num, compress_index.length);
-            // count_num += compress_counts.length;
-
-            System.arraycopy(compress_counts, 0, counts_data_tmp, count_num, compress_len);
-            System.arraycopy(compress_index, 0, counts_index_tmp, count_num, compress_len);
+            counts_pos[i] = this.compress_cache_pos[rel_vert_id];
             count_num += compress_len;
-
         }
 
         v_offset[v_num] = count_num;
-        //trim the tmp array
-        float[] counts_data = new float[count_num];
-        short[] counts_index = new short[count_num];
-
-        System.arraycopy(counts_data_tmp, 0, counts_data, 0, count_num);
-        System.arraycopy(counts_index_tmp, 0, counts_index, 0, count_num);
 
-        counts_data_tmp = null;
-        counts_index_tmp = null;
-
-        SCSet set = new SCSet(v_num, count_num, v_offset, counts_data, counts_index);
+        SCSet set = new SCSet(v_num, count_num, v_offset, counts_pos, this.compress_cache_counts, this.compress_cache_index);
 
         if (this.verbose)
         {
@@ -2030,7 +2037,6 @@ public class colorcount_HJ {
                     + (effective_size*4));
             LOG.info("Actual counts array size after compression: " + count_num + "; mem usage: " +
                     ((long)count_num*6));
-            LOG.info("Save memory " + ((effective_size*4 - (long)count_num*6)/(double)(effective_size*4))*100.0f + "%");
         }
 
         this.time_comm += (System.currentTimeMillis() - this.start_comm);
@@ -2045,18 +2051,11 @@ public class colorcount_HJ {
         int v_num = vert_list.length;
         int[] v_offset = new int[v_num + 1];
 
-        //to be trimed
-        //counts_idx_tmp is not required, can be removed
-        float[] counts_data_tmp = new float[num_comb_max*v_num];
-        float[] compress_array = new float[num_comb_max];
-
-        // compress index uses short to save memory, support up to 32767 as max_comb_len
-        short[] counts_index_tmp = new short[num_comb_max*v_num];
-        short[] compress_index = new short[num_comb_max];
-
         int count_num = 0;
         int effective_v = 0;
 
+        // first pass counts the nonzero counts of each vert 
+        // so the send arrays are allocated at the exact size
         for(int i = 0; i< v_num; i++)
         {
             v_offset[i] = count_num;
@@ -2068,52 +2067,26 @@ public class colorcount_HJ {
             if (rel_vert_id < 0 || (this.dt.is_vertex_init_passive(rel_vert_id) == false))
                 continue;
 
-            //compress the sending counts and index
-            float[] counts_raw = this.dt.get_passive(rel_vert_id);
-            if (counts_raw == null)
-            {
-                LOG.info("ERROR: null passive counts array");
-                continue;
-            }
-
-            //check length 
-            if (counts_raw.length != num_comb_max)
-            {
-                LOG.info("ERROR: comb_max and passive counts len not matched");
-                continue;
-            }
-
-            int compress_itr = 0;
-            for(int j=0; j<counts_raw.length; j++)
-            {
-                if (counts_raw[j] > 0.0f)
-                {
-                    compress_array[compress_itr] = counts_raw[j];
-                    compress_index[compress_itr] = (short)j;
-                    compress_itr++;
-                }
-            }
-
             effective_v++;
-
-            System.arraycopy(compress_array, 0, counts_data_tmp, count_num, compress_itr);
-            System.arraycopy(compress_index, 0, counts_index_tmp, count_num, compress_itr);
-            count_num += compress_itr;
-
+            count_num += this.dt.count_passive(rel_vert_id);
         }
 
         v_offset[v_num] = count_num;
-        //trim the tmp array
+
+        // compress index uses short to save memory, support up to 32767 as max_comb_len
         float[] counts_data = new float[count_num];
         short[] counts_index = new short[count_num];
 
-        System.arraycopy(counts_data_tmp, 0, counts_data, 0, count_num);
-        System.arraycopy(counts_index_tmp, 0, counts_index, 0, count_num);
+        // second pass compresses the passive counts from the table
+        // directly into the send arrays
+        for(int i = 0; i< v_num; i++)
+        {
+            if (v_offset[i] == v_offset[i+1])
+                continue;
 
-        counts_data_tmp = null;
-        counts_index_tmp = null;
-        compress_array = null;
-        compress_index = null;
+            int rel_vert_id = this.g.get_relative_v_id(vert_list[i]); 
+            this.dt.compress_passive(rel_vert_id, counts_data, counts_index, v_offset[i]);
+        }
 
         SCSet set = new SCSet(v_num, count_num, v_offset, counts_data, counts_index);
 
@@ -2145,15 +2118,12 @@ public class colorcount_HJ {
     {
 
         cc_ato[threadIdx] = 0.0;
+        int num_colorsets = dt.get_num_color_set(sub_id);
         
         for (int v = chunks[threadIdx]; v < chunks[threadIdx + 1]; ++v) 
         {
-            float[] counts_a_test_cur = dt.get_table(sub_id, v);
-            if (counts_a_test_cur != null)
-            {
-                for(int x = 0; x< counts_a_test_cur.length; x++)
-                    cc_ato[threadIdx] += (double)counts_a_test_cur[x];
-            }
+            for(int x = 0; x< num_colorsets; x++)
+                cc_ato[threadIdx] += (double)dt.get(sub_id, v, x);
         }
 
     }
@@ -2188,11 +2158,7 @@ public class colorcount_HJ {
         //after regroup update for one subtemplate
         if (threadIdx == 0)
         {
-            for(int i=0; i<this.num_verts_graph; i++)
-            {
-                this.compress_cache_array[i] = null;
-                this.compress_cache_index[i] = null;
-            }
+            release_compress_cache();
         }
 
         this.barrier.await();
@@ -2422,11 +2388,7 @@ public class colorcount_HJ {
         //release the compressed sending data
         if (threadIdx == 0)
         {
-            for(int i=0; i<this.num_verts_graph; i++)
-            {
-                this.compress_cache_array[i] = null;
-                this.compress_cache_index[i] = null;
-            }
+            release_compress_cache();
         }
      
         this.barrier.await();
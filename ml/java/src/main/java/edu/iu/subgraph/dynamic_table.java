@@ -57,6 +57,80 @@ public abstract class dynamic_table {
 
     public abstract boolean is_sub_init(int subtemplate);
 
+    public abstract void init_sub(int subtemplate, int active_child, int passive_child);
+
+    public abstract float get(int subtemplate, int vertex, int comb_num_index);
+
+    public abstract void set(int vertex, int comb_num_index, float count);
+
+    public abstract void update_comm(int vertex, int comb_num_index, float count);
+
+    public abstract boolean is_vertex_init_active(int vertex);
+
+    public abstract boolean is_vertex_init_passive(int vertex);
+
+    /**
+     * @brief get the counts of vertex on the active child
+     *
+     * @param vertex
+     * @param buf used if the counts are not kept in a row array
+     *
+     * @return the counts indexed by comb number
+     */
+    public abstract float[] get_active(int vertex, float[] buf);
+
+    /**
+     * @brief add the counts of vertex on the passive child to sum
+     *
+     * @param vertex
+     * @param sum
+     */
+    public abstract void add_passive(int vertex, double[] sum);
+
+    /**
+     * @brief add the counts of the verts on the passive child to sum
+     *
+     * @param vertices
+     * @param num num of verts in vertices
+     * @param sum
+     */
+    public void add_passive(int[] vertices, int num, double[] sum){
+        for(int i = 0; i < num; ++i)
+            add_passive(vertices[i], sum);
+    }
+
+    /**
+     * @brief the num of nonzero counts of vertex on the passive child
+     *
+     * @param vertex
+     *
+     * @return 
+     */
+    public abstract int count_passive(int vertex);
+
+    /**
+     * @brief write the nonzero counts of vertex on the passive child
+     * and their comb number indexes starting from pos
+     *
+     * @param vertex
+     * @param counts
+     * @param index
+     * @param pos
+     *
+     * @return the num of counts written
+     */
+    public abstract int compress_passive(int vertex, float[] counts, short[] index, int pos);
+
+    public abstract void set_to_table(int s, int d);
+
+    public int get_num_color_set(int s) 
+    {
+        if (num_colorsets != null )
+            return num_colorsets[s];
+        else
+            return 0;
+    }
+
     protected void init_choose_table(){
         choose_table = new int[num_colors + 1][num_colors + 1];
 
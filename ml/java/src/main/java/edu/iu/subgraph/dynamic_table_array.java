@@ -92,6 +92,7 @@ public class dynamic_table_array extends dynamic_table{
 
     }
 
+    @Override
     public void init_sub(int subtemplate, int active_child, int passive_child){
         if( active_child != SCConstants.NULL_VAL && passive_child != SCConstants.NULL_VAL){
             cur_table_active = table[active_child];
@@ -146,6 +147,7 @@ public class dynamic_table_array extends dynamic_table{
     }
 
 
+    @Override
     public float get(int subtemplate, int vertex, int comb_num_index){
         if( table[subtemplate][vertex] != null){
             float retval = table[subtemplate][vertex][comb_num_index];
@@ -172,6 +174,49 @@ public class dynamic_table_array extends dynamic_table{
         return cur_table_active[vertex];
     }
 
+    @Override
+    public float[] get_active(int vertex, float[] buf){
+        return cur_table_active[vertex];
+    }
+
+    @Override
+    public void add_passive(int vertex, double[] sum){
+        float[] counts = cur_table_passive[vertex];
+        if( counts != null){
+            for(int c = 0; c < counts.length; ++c)
+                sum[c] += counts[c];
+        }
+    }
+
+    @Override
+    public int count_passive(int vertex){
+        float[] counts = cur_table_passive[vertex];
+        int count = 0;
+        if( counts != null){
+            for(int c = 0; c < counts.length; ++c){
+                if (counts[c] > 0.0f)
+                    count++;
+            }
+        }
+        return count;
+    }
+
+    @Override
+    public int compress_passive(int vertex, float[] counts, short[] index, int pos){
+        float[] counts_raw = cur_table_passive[vertex];
+        int count = 0;
+        if( counts_raw != null){
+            for(int c = 0; c < counts_raw.length; ++c){
+                if (counts_raw[c] > 0.0f){
+                    counts[pos + count] = counts_raw[c];
+                    index[pos + count] = (short)c;
+                    count++;
+                }
+            }
+        }
+        return count;
+    }
+
     public float[] get_passive(int vertex){
         return cur_table_passive[vertex];
     }
@@ -204,6 +249,7 @@ public class dynamic_table_array extends dynamic_table{
     }
 
 
+    @Override
     public void set(int vertex, int comb_num_index, float count){
         if( cur_table[vertex] == null){
             cur_table[vertex] = new float[ num_colorsets[cur_sub] ];
@@ -219,6 +265,7 @@ public class dynamic_table_array extends dynamic_table{
     }
 
     //shall deal with the uninit vertex in local
+    @Override
     public void update_comm(int vertex, int comb_num_index, float count){
 
         if( cur_table[vertex] == null){
@@ -244,6 +291,7 @@ public class dynamic_table_array extends dynamic_table{
         return this.is_sub_inited[subtemplate];
     }
 
+    @Override
     public boolean is_vertex_init_active(int vertex){
         if( cur_table_active[vertex] != null)
             return true;
@@ -251,6 +299,7 @@ public class dynamic_table_array extends dynamic_table{
             return false;
     }
 
+    @Override
     public boolean is_vertex_init_passive(int vertex){
         if(cur_table_passive[vertex] != null)
             return true;
@@ -258,15 +307,7 @@ public class dynamic_table_array extends dynamic_table{
             return false;
     }
 
-
-    public int get_num_color_set(int s) 
-    {
-        if (num_colorsets != null )
-            return num_colorsets[s];
-        else
-            return 0;
-    }
-
+    @Override
     public void set_to_table(int s, int d)
     {
         table[d] = table[s]; 
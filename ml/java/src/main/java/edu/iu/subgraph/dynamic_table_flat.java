@@ -0,0 +1,570 @@
+/*
+ * Copyright 2013-2017 Indiana University
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package edu.iu.subgraph;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.io.UncheckedIOException;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.FloatBuffer;
+import java.nio.channels.FileChannel;
+import java.util.Arrays;
+import java.util.concurrent.atomic.AtomicInteger;
+
+/**
+ * @brief A dynamic table keeping the counts of each subtemplate
+ * in a few large blocks instead of one array per vertex.
+ * Only the vertices with counts get a row, and rows are numbered
+ * densely in the order they are first set. A block holds whole rows,
+ * so the counts of a vertex are always contiguous.
+ * With off_heap, blocks are direct buffers outside the Java heap.
+ * With a map dir, blocks are files mapped from that dir, so the
+ * table can be paged out to the local disk instead of failing.
+ */
+public class dynamic_table_flat extends dynamic_table{
+
+    // max num of floats in a block (1GB)
+    public static final int MAX_BLOCK_LEN = 1 << 28;
+
+    // num of colorsets summed at a time, the slice of the sum
+    // (8KB) stays in L1 while the rows of all the nbrs are added
+    public static final int SUM_BLOCK_LEN = 1024;
+
+    private static final int NULL_ROW = -1;
+
+    private final boolean off_heap;
+    private final File map_dir;
+
+    // subtemplate-rows
+    private count_rows[] table;
+    private count_rows cur_table;
+    private count_rows cur_table_active;
+    private count_rows cur_table_passive;
+
+    private int max_abs_vid;
+
+    int cur_sub;
+
+    public dynamic_table_flat(boolean off_heap){
+        super();
+        this.off_heap = off_heap;
+        this.map_dir = null;
+    }
+
+    /**
+     * @brief a table with the blocks mapped from files in map_dir
+     *
+     * @param map_dir
+     */
+    public dynamic_table_flat(File map_dir){
+        super();
+        this.off_heap = true;
+        this.map_dir = map_dir;
+    }
+
+    @Override
+    public void init(Graph[] subtemplates, int num_subtemplates, int num_vertices, int num_colors, int max_abs_vid) {
+        this.subtemplates = subtemplates;
+        this.num_subs = num_subtemplates;
+        this.num_verts = num_vertices;
+        this.num_colors = num_colors;
+        this.max_abs_vid = max_abs_vid;
+
+        init_choose_table();
+        init_num_colorsets();
+
+        table = new count_rows[ this.num_subs ];
+        is_sub_inited = new boolean[ this.num_subs];
+
+        for(int s = 0; s < this.num_subs; ++s){
+            is_sub_inited[s] = false;
+        }
+
+        is_inited = true;
+    }
+
+    @Override
+    public void init_sub(int subtemplate) {
+        init_sub(subtemplate, this.num_verts);
+    }
+
+    /**
+     * @brief allocate the rows of subtemplate
+     *
+     * @param subtemplate
+     * @param capacity max num of vertices with counts
+     */
+    private void init_sub(int subtemplate, int capacity) {
+        if (off_heap)
+            table[subtemplate] = new direct_rows(num_verts, capacity, num_colorsets[subtemplate], map_dir);
+        else
+            table[subtemplate] = new heap_rows(num_verts, capacity, num_colorsets[subtemplate]);
+
+        cur_table = table[subtemplate];
+        cur_sub = subtemplate;
+        is_sub_inited[subtemplate] = true;
+    }
+
+    /**
+     * @brief A vertex gets counts on subtemplate only if
+     * it has counts on the active child, so the active child
+     * bounds the num of rows. Dangling subtemplates other than
+     * the last one share its table by set_to_table and are not allocated.
+     *
+     * @param subtemplate
+     * @param active_child
+     * @param passive_child
+     */
+    @Override
+    public void init_sub(int subtemplate, int active_child, int passive_child){
+        if( active_child != SCConstants.NULL_VAL && passive_child != SCConstants.NULL_VAL){
+            cur_table_active = table[active_child];
+            cur_table_passive = table[passive_child];
+        }else{
+            cur_table_active = null;
+            cur_table_passive = null;
+        }
+
+        if (subtemplate == 0)
+            return;
+
+        if (cur_table_active != null)
+            init_sub(subtemplate, cur_table_active.get_num_rows());
+        else if (subtemplate == num_subs - 1)
+            init_sub(subtemplate, this.num_verts);
+        else
+        {
+            cur_table = null;
+            cur_sub = subtemplate;
+        }
+    }
+
+    @Override
+    public void clear_sub(int subtemplate) {
+        // direct and mapped blocks are freed when collected
+        table[subtemplate] = null;
+        is_sub_inited[subtemplate] = false;
+    }
+
+    @Override
+    public void clear_table() {
+        for( int s = 0; s < num_subs; s++){
+            table[s] = null;
+        }
+
+        cur_table = null;
+        cur_table_active = null;
+        cur_table_passive = null;
+        table = null;
+        is_sub_inited = null;
+    }
+
+    @Override
+    public float get(int subtemplate, int vertex, int comb_num_index){
+        count_rows rows = table[subtemplate];
+        int row = rows.row_ids[vertex];
+        if (row != NULL_ROW)
+            return rows.get(row, comb_num_index);
+        else
+            return 0.0f;
+    }
+
+    @Override
+    public float[] get_active(int vertex, float[] buf){
+        cur_table_active.get_row(cur_table_active.row_ids[vertex], buf);
+        return buf;
+    }
+
+    @Override
+    public void add_passive(int vertex, double[] sum){
+        int row = cur_table_passive.row_ids[vertex];
+        if (row != NULL_ROW)
+            cur_table_passive.add_row(row, sum, 0, cur_table_passive.row_len);
+    }
+
+    /**
+     * @brief long rows are summed block by block of colorsets, 
+     * so the sum is not evicted from the cache by each nbr row
+     */
+    @Override
+    public void add_passive(int[] vertices, int num, double[] sum){
+        count_rows rows = cur_table_passive;
+        if (rows.row_len <= SUM_BLOCK_LEN)
+        {
+            super.add_passive(vertices, num, sum);
+            return;
+        }
+
+        for(int from = 0; from < rows.row_len; from += SUM_BLOCK_LEN)
+        {
+            int to = Math.min(from + SUM_BLOCK_LEN, rows.row_len);
+            for(int i = 0; i < num; ++i)
+            {
+                int row = rows.row_ids[vertices[i]];
+                if (row != NULL_ROW)
+                    rows.add_row(row, sum, from, to);
+            }
+        }
+    }
+
+    @Override
+    public int count_passive(int vertex){
+        int row = cur_table_passive.row_ids[vertex];
+        if (row != NULL_ROW)
+            return cur_table_passive.count_nonzeros(row);
+        else
+            return 0;
+    }
+
+    @Override
+    public int compress_passive(int vertex, float[] counts, short[] index, int pos){
+        int row = cur_table_passive.row_ids[vertex];
+        if (row != NULL_ROW)
+            return cur_table_passive.compress_row(row, counts, index, pos);
+        else
+            return 0;
+    }
+
+    @Override
+    public void set(int vertex, int comb_num_index, float count){
+        cur_table.set(cur_table.get_or_add_row(vertex), comb_num_index, count);
+    }
+
+    //shall deal with the uninit vertex in local
+    @Override
+    public void update_comm(int vertex, int comb_num_index, float count){
+        cur_table.add(cur_table.get_or_add_row(vertex), comb_num_index, count);
+    }
+
+    @Override
+    public boolean is_init() {
+        return this.is_inited;
+    }
+
+    @Override
+    public boolean is_sub_init(int subtemplate) {
+        return this.is_sub_inited[subtemplate];
+    }
+
+    @Override
+    public boolean is_vertex_init_active(int vertex){
+        return cur_table_active.row_ids[vertex] != NULL_ROW;
+    }
+
+    @Override
+    public boolean is_vertex_init_passive(int vertex){
+        return cur_table_passive.row_ids[vertex] != NULL_ROW;
+    }
+
+    @Override
+    public void set_to_table(int s, int d)
+    {
+        table[d] = table[s];
+    }
+
+    /**
+     * @brief the num of bytes of count blocks held by subtemplate
+     *
+     * @param s
+     *
+     * @return
+     */
+    public long get_num_bytes(int s)
+    {
+        if (table[s] != null)
+            return (long)table[s].capacity*table[s].row_len*4L;
+        else
+            return 0L;
+    }
+
+    /**
+     * @brief The rows of one subtemplate. A row is assigned
+     * by the thread setting the vertex, and each vertex is
+     * set by only one thread, so only the row counter is shared.
+     */
+    private static abstract class count_rows {
+
+        // vertex-row
+        final int[] row_ids;
+        final int row_len;
+        final int rows_per_block;
+        final int capacity;
+        private final AtomicInteger num_rows;
+
+        count_rows(int num_verts, int capacity, int row_len)
+        {
+            this.row_ids = new int[num_verts];
+            Arrays.fill(this.row_ids, NULL_ROW);
+            this.row_len = row_len;
+            this.rows_per_block = Math.max(1, MAX_BLOCK_LEN/row_len);
+            this.capacity = capacity;
+            this.num_rows = new AtomicInteger(0);
+        }
+
+        int get_num_rows()
+        {
+            return num_rows.get();
+        }
+
+        int get_num_blocks()
+        {
+            return (capacity + rows_per_block - 1)/rows_per_block;
+        }
+
+        // num of floats in block b
+        int get_block_len(int b)
+        {
+            return Math.min(rows_per_block, capacity - b*rows_per_block)*row_len;
+        }
+
+        int get_or_add_row(int vertex)
+        {
+            int row = row_ids[vertex];
+            if (row == NULL_ROW)
+            {
+                row = num_rows.getAndIncrement();
+                if (row >= capacity)
+                    throw new IllegalStateException("Rows exceed capacity " + capacity);
+
+                row_ids[vertex] = row;
+            }
+            return row;
+        }
+
+        abstract float get(int row, int comb_num_index);
+
+        abstract void set(int row, int comb_num_index, float count);
+
+        abstract void add(int row, int comb_num_index, float count);
+
+        abstract void get_row(int row, float[] dst);
+
+        // add the counts of row from colorset from to colorset to
+        abstract void add_row(int row, double[] sum, int from, int to);
+
+        abstract int count_nonzeros(int row);
+
+        abstract int compress_row(int row, float[] counts, short[] index, int pos);
+    }
+
+    private static class heap_rows extends count_rows {
+
+        private final float[][] blocks;
+
+        heap_rows(int num_verts, int capacity, int row_len)
+        {
+            super(num_verts, capacity, row_len);
+            this.blocks = new float[get_num_blocks()][];
+            for(int b = 0; b < blocks.length; b++)
+                this.blocks[b] = new float[get_block_len(b)];
+        }
+
+        @Override
+        float get(int row, int comb_num_index)
+        {
+            int b = row/rows_per_block;
+            return blocks[b][(row - b*rows_per_block)*row_len + comb_num_index];
+        }
+
+        @Override
+        void set(int row, int comb_num_index, float count)
+        {
+            int b = row/rows_per_block;
+            blocks[b][(row - b*rows_per_block)*row_len + comb_num_index] = count;
+        }
+
+        @Override
+        void add(int row, int comb_num_index, float count)
+        {
+            int b = row/rows_per_block;
+            blocks[b][(row - b*rows_per_block)*row_len + comb_num_index] += count;
+        }
+
+        @Override
+        void get_row(int row, float[] dst)
+        {
+            int b = row/rows_per_block;
+            System.arraycopy(blocks[b], (row - b*rows_per_block)*row_len, dst, 0, row_len);
+        }
+
+        @Override
+        void add_row(int row, double[] sum, int from, int to)
+        {
+            int b = row/rows_per_block;
+            float[] block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            for(int c = from; c < to; c++)
+                sum[c] += block[start + c];
+        }
+
+        @Override
+        int count_nonzeros(int row)
+        {
+            int b = row/rows_per_block;
+            float[] block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            int count = 0;
+            for(int c = 0; c < row_len; c++)
+            {
+                if (block[start + c] > 0.0f)
+                    count++;
+            }
+            return count;
+        }
+
+        @Override
+        int compress_row(int row, float[] counts, short[] index, int pos)
+        {
+            int b = row/rows_per_block;
+            float[] block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            int count = 0;
+            for(int c = 0; c < row_len; c++)
+            {
+                float val = block[start + c];
+                if (val > 0.0f)
+                {
+                    counts[pos + count] = val;
+                    index[pos + count] = (short)c;
+                    count++;
+                }
+            }
+            return count;
+        }
+    }
+
+    private static class direct_rows extends count_rows {
+
+        private final FloatBuffer[] blocks;
+
+        /**
+         * @param map_dir the dir of the mapped files, 
+         * or null for direct buffers
+         */
+        direct_rows(int num_verts, int capacity, int row_len, File map_dir)
+        {
+            super(num_verts, capacity, row_len);
+            this.blocks = new FloatBuffer[get_num_blocks()];
+            // direct buffers and new mapped files are zero filled
+            for(int b = 0; b < blocks.length; b++)
+            {
+                ByteBuffer block = map_dir == null ? ByteBuffer.allocateDirect(get_block_len(b)*4)
+                    : map_block(map_dir, get_block_len(b)*4);
+                this.blocks[b] = block.order(ByteOrder.nativeOrder()).asFloatBuffer();
+            }
+        }
+
+        /**
+         * @brief map a new file, the file is deleted at once 
+         * and its pages are freed when the buffer is collected
+         */
+        private static ByteBuffer map_block(File map_dir, int num_bytes)
+        {
+            File file = null;
+            try {
+                file = File.createTempFile("dp-table-", ".blk", map_dir);
+                try (RandomAccessFile raf = new RandomAccessFile(file, "rw")) {
+                    return raf.getChannel().map(FileChannel.MapMode.READ_WRITE, 0L, num_bytes);
+                }
+            } catch (IOException e) {
+                throw new UncheckedIOException("Fail to map a block in " + map_dir, e);
+            } finally {
+                if (file != null)
+                    file.delete();
+            }
+        }
+
+        // absolute get/put only, the buffers are shared by threads
+        @Override
+        float get(int row, int comb_num_index)
+        {
+            int b = row/rows_per_block;
+            return blocks[b].get((row - b*rows_per_block)*row_len + comb_num_index);
+        }
+
+        @Override
+        void set(int row, int comb_num_index, float count)
+        {
+            int b = row/rows_per_block;
+            blocks[b].put((row - b*rows_per_block)*row_len + comb_num_index, count);
+        }
+
+        @Override
+        void add(int row, int comb_num_index, float count)
+        {
+            int b = row/rows_per_block;
+            int pos = (row - b*rows_per_block)*row_len + comb_num_index;
+            blocks[b].put(pos, blocks[b].get(pos) + count);
+        }
+
+        @Override
+        void get_row(int row, float[] dst)
+        {
+            int b = row/rows_per_block;
+            FloatBuffer block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            for(int c = 0; c < row_len; c++)
+                dst[c] = block.get(start + c);
+        }
+
+        @Override
+        void add_row(int row, double[] sum, int from, int to)
+        {
+            int b = row/rows_per_block;
+            FloatBuffer block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            for(int c = from; c < to; c++)
+                sum[c] += block.get(start + c);
+        }
+
+        @Override
+        int count_nonzeros(int row)
+        {
+            int b = row/rows_per_block;
+            FloatBuffer block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            int count = 0;
+            for(int c = 0; c < row_len; c++)
+            {
+                if (block.get(start + c) > 0.0f)
+                    count++;
+            }
+            return count;
+        }
+
+        @Override
+        int compress_row(int row, float[] counts, short[] index, int pos)
+        {
+            int b = row/rows_per_block;
+            FloatBuffer block = blocks[b];
+            int start = (row - b*rows_per_block)*row_len;
+            int count = 0;
+            for(int c = 0; c < row_len; c++)
+            {
+                float val = block.get(start + c);
+                if (val > 0.0f)
+                {
+                    counts[pos + count] = val;
+                    index[pos + count] = (short)c;
+                    count++;
+                }
+            }
+            return count;
+        }
+    }
+}